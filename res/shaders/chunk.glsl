@@ -1,3 +1,14 @@
 uint idx(in uint x, in uint y, in uint z) { return (y + 1) * SHARED_AREA + (z + 1) * SHARED_SIZE + (x + 1); }
 #define AT(x, y, z) blocks[idx(x, y, z)]
-#define BLOCK AT(gl_GlobalInvocationID.x, gl_GlobalInvocationID.y, gl_GlobalInvocationID.z)
\ No newline at end of file
+#define BLOCK AT(gl_GlobalInvocationID.x, gl_GlobalInvocationID.y, gl_GlobalInvocationID.z)
+
+// ANY and NONE (and anything else past the tables) aren't solid and use texture 0, like BlockRegistry
+#ifdef BLOCK_SOLID
+const uint block_solid[] = BLOCK_SOLID;
+bool isSolid(in uint block) { return block < uint(TOTAL_BLOCKS) && (block_solid[block >> 5] & (1u << (block & 31))) != 0; }
+#endif
+
+#ifdef BLOCK_TEXTURES
+const uint block_textures[] = BLOCK_TEXTURES;
+uint blockTexture(in uint block, in uint face) { return block < uint(TOTAL_BLOCKS) ? block_textures[block * 6 + face] : 0u; }
+#endif
\ No newline at end of file
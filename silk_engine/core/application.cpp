@@ -6,6 +6,10 @@
 #include "silk_engine/scene/scene.h"
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/scene/camera/camera.h"
+#include "task_scheduler.h"
+#include "event.h"
+#include "silk_engine/utils/frame_statistics.h"
+#include "silk_engine/utils/memory_tracker.h"
 
 Application::Application()
 {
@@ -13,17 +17,29 @@ Application::Application()
 
 void Application::run()
 {
+    Profiler::setThreadName("Main");
     while (running)
     {
-        if (Window::get().isMinimized())
-            glfwWaitEvents();
-        else
-            glfwPollEvents();
+        FrameStatistics::beginFrame();
+        {
+            SK_PROFILE_SCOPE("Frame");
+            {
+                SK_FRAME_STATISTICS_SCOPE("Events");
+                if (Window::get().isMinimized())
+                    glfwWaitEvents();
+                else
+                    glfwPollEvents();
+                EventQueue::dispatch();
+            }
             
-        update();
+            update();
 
-        Window::get().update();
-        Joystick::getActive().update();
+            Window::get().update();
+            Joystick::getActive().update();
+            Profiler::update();
+        }
+        FrameStatistics::endFrame();
+        MemoryTracker::update();
     }
     RenderContext::getLogicalDevice().wait();
 }
@@ -33,6 +49,8 @@ void Application::update()
     if (!running || Window::get().isMinimized())
         return;
 
+    SK_FRAME_STATISTICS_SCOPE("Update");
+    TaskScheduler::update();
     onUpdate();
     Time::update();
 }
\ No newline at end of file
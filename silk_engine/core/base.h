@@ -23,6 +23,8 @@
 #include <mutex>
 #include <span>
 #include <numeric>
+#include <atomic>
+#include <bit>
 
 #include <vulkan/vulkan.h>
 #define GLFW_INCLUDE_NONE
@@ -36,6 +38,12 @@ constexpr const char* ENGINE_NAME = "Silk";
 
 #define SK_ENABLE_DEBUG_MESSENGER (VK_EXT_debug_utils && defined(SK_ENABLE_DEBUG_OUTPUT))
 
+// Replaces global operator new/delete to attribute every allocation to a MemoryTracker tag. Every new and delete
+// then updates shared counters, so distribution builds leave it out and only track device memory
+#ifndef SK_DIST
+#define SK_ENABLE_MEMORY_TRACKING
+#endif
+
 #define SK_MAKE_VERSION(major, minor, patch) \
     (((uint32_t(major)) << 22)               \
     | ((uint32_t(minor)) << 12)              \
@@ -122,5 +130,6 @@ static constexpr auto makeArray(T&&... values) -> std::array<typename std::decay
 #include "silk_engine/core/platform.h"
 #include "silk_engine/core/log.h"
 #include "silk_engine/utils/time.h"
+#include "silk_engine/utils/profiler.h"
 #include "silk_engine/utils/random.h"
 #include "silk_engine/gfx/enums.h"
\ No newline at end of file
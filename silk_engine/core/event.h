@@ -1,6 +1,7 @@
 #pragma once
 
 #include <typeindex>
+#include "silk_engine/utils/concurrent_queue.h"
 
 class Window;
 class Monitor;
@@ -267,109 +268,231 @@ struct GamepadAxisEvent
     const float delta;
 };
 
+// Type erased event handler, a free function or an instance with a member function stored inline,
+// so a dispatcher keeps its handlers in one contiguous array instead of individually heap allocated objects
 template<typename EventType>
-class HandlerFunctionBase
+class EventHandler
 {
 public:
-    virtual void operator()(const EventType& event) const = 0;
-    virtual bool operator==(size_t func) const = 0;
+    EventHandler(void (*function)(const EventType&))
+        : invoke(&invokeFunction)
+    {
+        memcpy(storage, &function, sizeof(function));
+    }
+
+    template<typename T>
+    EventHandler(T& instance, void (T::* member_function)(const EventType&))
+        : invoke(&invokeMemberFunction<T>), instance(&instance)
+    {
+        static_assert(sizeof(member_function) <= STORAGE_SIZE, "Member function pointer doesn't fit in event handler");
+        memcpy(storage, &member_function, sizeof(member_function));
+    }
+
+    void operator()(const EventType& event) const { invoke(*this, event); }
+
+    bool operator==(const EventHandler& other) const
+    {
+        return invoke == other.invoke && instance == other.instance && !memcmp(storage, other.storage, STORAGE_SIZE);
+    }
+
+private:
+    static constexpr size_t STORAGE_SIZE = 3 * sizeof(void*); // Largest member function pointer (MSVC, unknown inheritance)
+
+    static void invokeFunction(const EventHandler& handler, const EventType& event)
+    {
+        void (*function)(const EventType&) = nullptr;
+        memcpy(&function, handler.storage, sizeof(function));
+        function(event);
+    }
+
+    template<typename T>
+    static void invokeMemberFunction(const EventHandler& handler, const EventType& event)
+    {
+        void (T::* member_function)(const EventType&) = nullptr;
+        memcpy(&member_function, handler.storage, sizeof(member_function));
+        (scast<T*>(handler.instance)->*member_function)(event);
+    }
+
+private:
+    void (*invoke)(const EventHandler&, const EventType&) = nullptr;
+    void* instance = nullptr;
+    alignas(void*) std::byte storage[STORAGE_SIZE] = {};
 };
 
-template <typename T, typename EventType>
-class MemberFunctionHandler : public HandlerFunctionBase<EventType>
+// Handles events queued with Dispatcher<EventType>::enqueue() of every event type
+class EventQueue
 {
-    typedef void (T::* MemberFunction)(const EventType&);
-public:
-    MemberFunctionHandler(T& instance, MemberFunction member_function)
-        : instance(instance), member_function(member_function) {}
+    template<typename EventType>
+    friend class Dispatcher;
 
-    void operator()(const EventType& event) const
+public:
+    // Called once per frame on the main thread, right after window events are polled
+    static void dispatch()
     {
-        (instance.*member_function)(event);
+        for (size_t i = 0;; ++i)
+        {
+            void (*dispatch_queued)() = nullptr;
+            {
+                std::scoped_lock lock(mutex);
+                if (i >= dispatchers.size())
+                    break;
+                dispatch_queued = dispatchers[i];
+            }
+            dispatch_queued();
+        }
     }
 
-    bool operator==(size_t func) const override
+private:
+    static void add(void (*dispatch_queued)())
     {
-        union {
-            MemberFunction member_function;
-            size_t hash;
-        } converter;
-        converter.member_function = member_function;
-        return func == (size_t(&instance) ^ converter.hash);
+        std::scoped_lock lock(mutex);
+        dispatchers.emplace_back(dispatch_queued);
     }
 
 private:
-    T& instance;
-    MemberFunction member_function;
+    static inline std::vector<void (*)()> dispatchers;
+    static inline std::mutex mutex;
 };
 
 template <typename EventType>
 class Dispatcher
 {
 public:
+    static constexpr size_t QUEUE_CAPACITY = 256;
+
+public:
+    // Handles the event right away on the calling thread. Handlers run on a snapshot of the handler list and without
+    // holding the lock, so they may post, subscribe or unsubscribe, which takes effect from the next event on
     static void post(const EventType& e)
     {
-        for (auto& func : subscribed_functions)
-            func(e);
-        for (auto& func : subscribed_member_functions)
-            (*func)(e);
+        shared<const Handlers> snapshot = nullptr;
+        {
+            std::scoped_lock lock(handler_mutex);
+            snapshot = handlers;
+        }
+        if (!snapshot)
+            return;
+        for (const auto& handler : *snapshot)
+            handler(e);
     }
 
     template <typename... Args>
     static void post(Args&&... args)
     {
-        EventType e(std::forward<Args>(args)...);
-        for (auto& func : subscribed_functions)
-            func(e);
-        for (auto& func : subscribed_member_functions)
-            (*func)(e);
+        const EventType e(std::forward<Args>(args)...);
+        post(e);
+    }
+
+    // Callable from any thread, the event is constructed in a lock-free per type queue and handled on the main thread
+    // in EventQueue::dispatch(). Events of one type keep the order they were queued in by a thread, there's no order between types.
+    // The event is copied and handled later, so it can't point to memory owned by the caller
+    template <typename... Args>
+    static void enqueue(Args&&... args)
+    {
+        static_assert(!std::is_same_v<EventType, DragAndDropEvent>, "DragAndDropEvent points to paths that only live during the GLFW callback, post it instead");
+        [[maybe_unused]] static const bool registered = (EventQueue::add(&dispatchQueued), true);
+        // Once something spilled, later events spill behind it until it's dispatched, so they can't overtake it through the queue
+        if (!spilling.load(std::memory_order_acquire) && getQueue().tryEmplace(std::forward<Args>(args)...))
+            return;
+        // Queue is full until the next dispatch, spill rather than block the producer
+        std::scoped_lock lock(overflow_mutex);
+        overflow.emplace_back(std::forward<Args>(args)...);
+        spilling.store(true, std::memory_order_relaxed);
     }
 
     template <typename T>
     static void subscribe(T& instance, void (T::* member_function)(const EventType&))
     {
-        subscribed_member_functions.emplace_back(new MemberFunctionHandler<T, EventType>(instance, member_function));
+        add(EventHandler<EventType>(instance, member_function));
     }
 
     static void subscribe(void (*function)(const EventType&))
     {
-        subscribed_functions.emplace_back(function);
+        add(EventHandler<EventType>(function));
     }
 
     static void unsubscribe(void (*function)(const EventType&))
     {
-        for (auto& func : subscribed_functions)
-        {
-            if (func == function)
-            {
-                std::swap(func, subscribed_functions.back());
-                subscribed_functions.pop_back();
-                break;
-            }
-        }
+        remove(EventHandler<EventType>(function));
     }
 
     template <typename T>
     static void unsubscribe(T& instance, void (T::* member_function)(const EventType&))
     {
-        union {
-            void (T::* member_function)(const EventType&);
-            size_t hash;
-        } converter;
-        converter.member_function = member_function;
-        size_t function_hash = size_t(&instance) ^ converter.hash;
-        for (auto& member_func : subscribed_member_functions)
+        remove(EventHandler<EventType>(instance, member_function));
+    }
+
+private:
+    using Handlers = std::vector<EventHandler<EventType>>;
+
+private:
+    // Copy on write, posts in progress keep iterating the list they started with
+    static void add(const EventHandler<EventType>& added)
+    {
+        std::scoped_lock lock(handler_mutex);
+        auto updated = handlers ? makeShared<Handlers>(*handlers) : makeShared<Handlers>();
+        updated->emplace_back(added);
+        handlers = std::move(updated);
+    }
+
+    static void remove(const EventHandler<EventType>& removed)
+    {
+        std::scoped_lock lock(handler_mutex);
+        if (!handlers)
+            return;
+        auto it = std::ranges::find(*handlers, removed);
+        if (it == handlers->end())
+            return;
+        // Erased in place, handlers keep being called in the order they subscribed
+        auto updated = makeShared<Handlers>(*handlers);
+        updated->erase(updated->begin() + (it - handlers->begin()));
+        handlers = std::move(updated);
+    }
+
+    // Created by the first enqueue, most event types are only ever posted
+    static MPMCQueue<EventType>& getQueue()
+    {
+        static MPMCQueue<EventType> queue(QUEUE_CAPACITY);
+        return queue;
+    }
+
+    static void dispatchQueued()
+    {
+        // Only what was queued so far, events queued while handling wait for the next dispatch
+        MPMCQueue<EventType>& queue = getQueue();
+        size_t count = 0;
+        std::vector<EventType> spilled;
         {
-            if (*member_func == function_hash)
-            {
-                std::swap(member_func, subscribed_member_functions.back());
-                subscribed_member_functions.pop_back();
-                break;
-            }
+            std::scoped_lock lock(overflow_mutex);
+            // Nothing enters the queue while spilling, so every queued event older than the spilled ones is within count
+            count = queue.size();
+            spilled.swap(overflow);
+            spilling.store(false, std::memory_order_release);
+        }
+        size_t consumed = 0;
+        while (consumed < count && queue.tryConsume([](const EventType& e) { post(e); }))
+            ++consumed;
+
+        if (spilled.empty())
+            return;
+        if (consumed < count)
+        {
+            // A producer is still writing an older event, keep the spilled ones behind it for the next dispatch
+            std::scoped_lock lock(overflow_mutex);
+            for (auto& e : overflow)
+                spilled.emplace_back(std::move(e));
+            overflow.swap(spilled);
+            spilling.store(true, std::memory_order_relaxed);
+            return;
         }
+        for (const auto& e : spilled)
+            post(e);
     }
 
 private:
-    static inline std::vector<void(*)(const EventType&)> subscribed_functions;
-    static inline std::vector<unique<HandlerFunctionBase<EventType>>> subscribed_member_functions;
+    static inline shared<const Handlers> handlers = nullptr;
+    static inline std::mutex handler_mutex;
+    static inline std::vector<EventType> overflow;
+    static inline std::mutex overflow_mutex;
+    static inline std::atomic<bool> spilling = false;
 };
\ No newline at end of file
@@ -1,9 +1,42 @@
 #include "log.h"
 #ifdef SK_ENABLE_DEBUG_OUTPUT
     #include <spdlog/sinks/ansicolor_sink.h>
+    #include <spdlog/sinks/base_sink.h>
 #endif
 
-void Log::init()
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+class BinaryFileSink : public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+    BinaryFileSink(const fs::path& file)
+        : stream(file, std::ios::binary | std::ios::trunc) {}
+
+protected:
+    void sink_it_(const spdlog::details::log_msg& message) override
+    {
+        uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(message.time.time_since_epoch()).count();
+        uint8_t level = uint8_t(message.level);
+        uint8_t name_size = uint8_t(std::min(message.logger_name.size(), size_t(255)));
+        uint32_t message_size = uint32_t(message.payload.size());
+        stream.write(rcast<const char*>(&time), sizeof(time));
+        stream.write(rcast<const char*>(&level), sizeof(level));
+        stream.write(rcast<const char*>(&name_size), sizeof(name_size));
+        stream.write(message.logger_name.data(), name_size);
+        stream.write(rcast<const char*>(&message_size), sizeof(message_size));
+        stream.write(message.payload.data(), message_size);
+    }
+
+    void flush_() override
+    {
+        stream.flush();
+    }
+
+private:
+    std::ofstream stream;
+};
+#endif
+
+void Log::init(bool async)
 {
 #ifdef SK_ENABLE_DEBUG_OUTPUT
     using namespace spdlog;
@@ -18,13 +51,101 @@ void Log::init()
     core_sink->set_color(level::critical, "\033[1m\033[41m");
     core_sink->set_level(level::trace);
 
+    // The background thread flushes whenever it runs out of messages
+    level::level_enum flush_level = async ? level::err : level::trace;
     core_logger = makeShared<logger>(ENGINE_NAME, core_sink);
     core_logger->set_level(level::trace);
-    core_logger->flush_on(level::trace);
+    core_logger->flush_on(flush_level);
     register_logger(core_logger);
     client_logger = makeShared<logger>("App", core_sink);
     client_logger->set_level(level::trace);
-    client_logger->flush_on(level::trace);
+    client_logger->flush_on(flush_level);
     register_logger(client_logger);
+
+    if (async)
+    {
+        queue = makeUnique<MPMCQueue<Record>>(QUEUE_CAPACITY);
+        thread = std::thread(&Log::process);
+        running = true;
+    }
+#endif
+}
+
+void Log::destroy()
+{
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+    if (!running.exchange(false))
+        return;
+    // Producers that already got in still push, the thread keeps draining so blocked ones get their space
+    for (uint32_t current = producers.load(); current; current = producers.load())
+        producers.wait(current);
+    ++submitted;
+    queue->emplace(); // Stop record, written after every pending message
+    thread.join();
+    queue = nullptr;
+    core_logger->flush();
+    client_logger->flush();
 #endif
-}
\ No newline at end of file
+}
+
+void Log::flush()
+{
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+    uint64_t target = submitted.load();
+    for (uint64_t current = processed.load(); current < target; current = processed.load())
+        processed.wait(current);
+    core_logger->flush();
+    client_logger->flush();
+#endif
+}
+
+void Log::openBinaryFile(const fs::path& file)
+{
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+    if (file.has_parent_path() && !fs::exists(file.parent_path()))
+        fs::create_directories(file.parent_path());
+    flush();
+    auto sink = makeShared<BinaryFileSink>(file);
+    sink->set_level(spdlog::level::trace);
+    core_logger->sinks().emplace_back(sink);
+    client_logger->sinks().emplace_back(sink);
+#endif
+}
+
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+void Log::process()
+{
+    Profiler::setThreadName("Log");
+    std::string message;
+    size_t reported_drops = 0;
+    bool processing = true;
+    auto write = [&](Record& record)
+    {
+        if (!record.logger)
+        {
+            processing = false;
+            return;
+        }
+        record.format(message);
+        record.logger->log(record.time, record.source, record.level, message);
+    };
+
+    while (processing)
+    {
+        if (!queue->tryConsume(write))
+        {
+            // Out of messages, flush what was written and report drops before waiting for more
+            if (size_t dropped = dropped_messages.load(); dropped != reported_drops)
+            {
+                core_logger->warn("Dropped {} log messages, the log queue was full", dropped - reported_drops);
+                reported_drops = dropped;
+            }
+            core_logger->flush();
+            client_logger->flush();
+            queue->consume(write);
+        }
+        ++processed;
+        processed.notify_all();
+    }
+}
+#endif
\ No newline at end of file
@@ -106,20 +106,158 @@ namespace std
     #define SPDLOG_USE_STD_FORMAT
     #define SPDLOG_ACTIVE_LEVEL 0
     #include <spdlog/spdlog.h>
+    #include "silk_engine/utils/concurrent_queue.h"
 #endif
 
+// In async mode (the default) log calls copy their format arguments into a lock-free ring buffer and a background
+// thread formats and writes them, so the calling thread never formats or flushes. When the buffer is full messages
+// below warning are dropped (and counted), warnings and errors wait for space, critical messages flush the buffer
+// and are written straight away since they abort right after
 class Log
 {
 public:
-    static void init();
+    static constexpr size_t QUEUE_CAPACITY = 8192;
+
+public:
+    static void init(bool async = true);
+    // Flushes pending messages and stops the background thread
+    static void destroy();
+    // Blocks until every message logged so far is written
+    static void flush();
+    // Also writes every message to file as binary records:
+    // [u64 nanoseconds since unix epoch][u8 level][u8 logger name size][logger name][u32 message size][message]
+    static void openBinaryFile(const fs::path& file);
 
 #ifdef SK_ENABLE_DEBUG_OUTPUT
     static shared<spdlog::logger>& getCoreLogger() { return core_logger; }
     static shared<spdlog::logger>& getClientLogger() { return client_logger; }
+    static size_t getDroppedMessages() { return dropped_messages; }
+
+    template<typename... Args>
+    static void log(spdlog::logger& logger, spdlog::level::level_enum level, spdlog::source_loc source, std::format_string<Args...> format, Args&&... args)
+    {
+        if (logger.should_log(level))
+            write(logger, level, source, format.get(), std::forward<Args>(args)...);
+    }
+
+    // Message without format arguments, like spdlog it's written as is
+    template<typename T>
+    static void log(spdlog::logger& logger, spdlog::level::level_enum level, spdlog::source_loc source, const T& message)
+    {
+        if (logger.should_log(level))
+            write(logger, level, source, "{}", message);
+    }
+
+private:
+    // Holds a copy of the format arguments, strings are copied since pointers may not outlive the call
+    class Record : NoCopyNoMove
+    {
+    public:
+        static constexpr size_t STORAGE = 192;
+
+        template<typename T>
+        using Captured = std::conditional_t<std::is_convertible_v<std::decay_t<T>, std::string_view>, std::string, std::decay_t<T>>;
+
+    public:
+        template<typename... Args>
+        Record(spdlog::logger* logger, spdlog::level::level_enum level, spdlog::source_loc source, std::string_view format, Args&&... args)
+            : logger(logger), level(level), source(source), format_string(format), time(spdlog::log_clock::now())
+        {
+            using Arguments = std::tuple<Captured<Args>...>;
+            if constexpr (sizeof(Arguments) <= STORAGE && alignof(Arguments) <= alignof(std::max_align_t))
+            {
+                new (storage) Arguments(std::forward<Args>(args)...);
+                format_function = [](const Record& record, std::string& message)
+                {
+                    std::apply([&](const auto&... arguments) { message = std::vformat(record.format_string, std::make_format_args(arguments...)); }, record.get<Arguments>());
+                };
+                destroy_function = [](Record& record) { record.get<Arguments>().~Arguments(); };
+            }
+            else
+            {
+                // Too big to defer, formatted on the calling thread
+                new (storage) std::string(std::vformat(format, std::make_format_args(args...)));
+                format_function = [](const Record& record, std::string& message) { message = record.get<std::string>(); };
+                destroy_function = [](Record& record) { std::destroy_at(&record.get<std::string>()); };
+            }
+        }
+        // Stop record for the background thread
+        Record() = default;
+        ~Record()
+        {
+            if (destroy_function)
+                destroy_function(*this);
+        }
+
+        void format(std::string& message) const { format_function(*this, message); }
+
+        template<typename T>
+        T& get() { return *std::launder(rcast<T*>(storage)); }
+        template<typename T>
+        const T& get() const { return *std::launder(rcast<const T*>(storage)); }
+
+    public:
+        spdlog::logger* logger = nullptr;
+        spdlog::level::level_enum level = spdlog::level::off;
+        spdlog::source_loc source = {};
+        std::string_view format_string = {};
+        spdlog::log_clock::time_point time = {};
+
+    private:
+        void(*format_function)(const Record&, std::string&) = nullptr;
+        void(*destroy_function)(Record&) = nullptr;
+        alignas(std::max_align_t) std::byte storage[STORAGE];
+    };
+
+    template<typename... Args>
+    static void write(spdlog::logger& logger, spdlog::level::level_enum level, spdlog::source_loc source, std::string_view format, Args&&... args)
+    {
+        if (level < spdlog::level::critical && running.load())
+        {
+            // Registered before checking again (both sequentially consistent), so destroy() either sees this producer and
+            // waits for it or this producer sees the flag cleared and logs synchronously
+            ++producers;
+            if (running.load())
+            {
+                ++submitted;
+                if (level >= spdlog::level::warn)
+                    queue->emplace(&logger, level, source, format, std::forward<Args>(args)...);
+                else if (!queue->tryEmplace(&logger, level, source, format, std::forward<Args>(args)...))
+                {
+                    ++processed; // Never written, keeps flush() from waiting on it
+                    processed.notify_all();
+                    ++dropped_messages;
+                }
+                leaveProducer();
+                return;
+            }
+            leaveProducer();
+        }
+
+        if (level >= spdlog::level::critical)
+            flush();
+        logger.log(source, level, std::vformat(format, std::make_format_args(args...)));
+    }
+
+    static void leaveProducer()
+    {
+        if (--producers == 0)
+            producers.notify_all();
+    }
+
+    static void process();
 
 private:
     static inline shared<spdlog::logger> core_logger = nullptr;
     static inline shared<spdlog::logger> client_logger = nullptr;
+    static inline unique<MPMCQueue<Record>> queue = nullptr;
+    static inline std::thread thread;
+    // Cleared by destroy() before the queue goes, producers that see it cleared log synchronously
+    static inline std::atomic<bool> running = false;
+    static inline std::atomic<uint32_t> producers = 0;
+    static inline std::atomic<uint64_t> submitted = 0;
+    static inline std::atomic<uint64_t> processed = 0;
+    static inline std::atomic<size_t> dropped_messages = 0;
 #endif
 };
 
@@ -147,17 +285,16 @@ private:
         return _sk_assert(assert_expr, "");
     }
 
-    #define SK_PROFILE_FUNCTION(...) DebugTimer __timer(__FUNCTION__)
-    #define SK_TRACE(...) SPDLOG_LOGGER_TRACE(SK_LOGGER, __VA_ARGS__)
-    #define SK_INFO(...) SPDLOG_LOGGER_INFO(SK_LOGGER, __VA_ARGS__)
-    #define SK_WARN(...) SPDLOG_LOGGER_WARN(SK_LOGGER, __VA_ARGS__)
-    #define SK_ERROR(...) SPDLOG_LOGGER_ERROR(SK_LOGGER, __VA_ARGS__)
-    #define SK_CRITICAL(...) do { SPDLOG_LOGGER_CRITICAL(SK_LOGGER, __VA_ARGS__); std::abort(); } while(0)
-    #define SK_VERIFY(x, ...) do { if (!(x)) { SPDLOG_LOGGER_ERROR(SK_LOGGER, _sk_assert(#x, __VA_ARGS__)); } } while(0)
-    #define SK_VERIFY_WARN(x, ...) do { if (!(x)) { SPDLOG_LOGGER_WARN(SK_LOGGER, _sk_assert(#x, __VA_ARGS__)); } } while(0)
-    #define SK_ASSERT(x, ...) do { if (!(x)) { SPDLOG_LOGGER_CRITICAL(SK_LOGGER, _sk_assert(#x, __VA_ARGS__)); std::abort(); } } while(0)
+    #define SK_LOG(level, ...) Log::log(*SK_LOGGER, level, spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION }, __VA_ARGS__)
+    #define SK_TRACE(...) SK_LOG(spdlog::level::trace, __VA_ARGS__)
+    #define SK_INFO(...) SK_LOG(spdlog::level::info, __VA_ARGS__)
+    #define SK_WARN(...) SK_LOG(spdlog::level::warn, __VA_ARGS__)
+    #define SK_ERROR(...) SK_LOG(spdlog::level::err, __VA_ARGS__)
+    #define SK_CRITICAL(...) do { SK_LOG(spdlog::level::critical, __VA_ARGS__); std::abort(); } while(0)
+    #define SK_VERIFY(x, ...) do { if (!(x)) { SK_LOG(spdlog::level::err, _sk_assert(#x, __VA_ARGS__)); } } while(0)
+    #define SK_VERIFY_WARN(x, ...) do { if (!(x)) { SK_LOG(spdlog::level::warn, _sk_assert(#x, __VA_ARGS__)); } } while(0)
+    #define SK_ASSERT(x, ...) do { if (!(x)) { SK_LOG(spdlog::level::critical, _sk_assert(#x, __VA_ARGS__)); std::abort(); } } while(0)
 #else
-    #define SK_PROFILE_FUNCTION(...)
     #define SK_TRACE(...)
     #define SK_INFO(...)
     #define SK_WARN(...)
@@ -0,0 +1,69 @@
+#include "task_scheduler.h"
+#include "silk_engine/gfx/render_context.h"
+#include "silk_engine/io/file.h"
+
+bool TaskScheduler::FrameFinishedAwaiter::await_ready() const
+{
+    return RenderContext::getFinishedFrames() > frame;
+}
+
+void TaskScheduler::FrameFinishedAwaiter::await_suspend(std::coroutine_handle<> handle) const
+{
+    std::scoped_lock lock(mux);
+    frame_finished_continuations.emplace_back(frame, handle);
+}
+
+void TaskScheduler::FileAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    ThreadPool::get().submit([this, handle]
+        {
+            File::read(file, data, std::ios::binary);
+            post(handle);
+        });
+}
+
+TaskScheduler::FrameFinishedAwaiter TaskScheduler::frameFinished()
+{
+    return { RenderContext::getFrameNumber() };
+}
+
+void TaskScheduler::destroy()
+{
+    ThreadPool::get().wait();
+    // Coroutines that are still suspended are never resumed, their owners destroy them
+    frame_continuations.clear();
+    frame_finished_continuations.clear();
+}
+
+void TaskScheduler::update()
+{
+    std::vector<std::coroutine_handle<>> continuations;
+    std::vector<std::pair<uint64_t, std::coroutine_handle<>>> frames;
+    {
+        std::scoped_lock lock(mux);
+        std::swap(continuations, frame_continuations);
+        std::swap(frames, frame_finished_continuations);
+    }
+
+    uint64_t finished_frames = RenderContext::getFinishedFrames();
+    for (auto&& [frame, handle] : frames)
+    {
+        if (finished_frames > frame)
+            continuations.emplace_back(handle);
+        else
+        {
+            std::scoped_lock lock(mux);
+            frame_finished_continuations.emplace_back(frame, handle);
+        }
+    }
+
+    // Coroutines awaiting again from here are queued for the next update
+    for (auto handle : continuations)
+        handle.resume();
+}
+
+void TaskScheduler::post(std::coroutine_handle<> handle)
+{
+    std::scoped_lock lock(mux);
+    frame_continuations.emplace_back(handle);
+}
\ No newline at end of file
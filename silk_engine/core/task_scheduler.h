@@ -0,0 +1,77 @@
+#pragma once
+
+#include "silk_engine/utils/task.h"
+#include "silk_engine/utils/thread_pool.h"
+
+// Resumes coroutines on the engine's job system (ThreadPool::get()), and coroutines waiting for the main thread
+// (next frame, frame's submissions finished, file read completed) once per frame in update().
+// Usage from a Task: co_await TaskScheduler::resumeOnWorker(); auto data = co_await TaskScheduler::readFile(path);
+class TaskScheduler
+{
+private:
+    struct WorkerAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { ThreadPool::get().submit([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    struct FrameAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { post(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct FrameFinishedAwaiter
+    {
+        uint64_t frame;
+
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<> handle) const;
+        void await_resume() const noexcept {}
+    };
+
+    struct JobAwaiter
+    {
+        ThreadPool::JobHandle job;
+
+        bool await_ready() const noexcept { return !job || job->isFinished(); }
+        void await_suspend(std::coroutine_handle<> handle) const { ThreadPool::get().then(job, [handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    struct FileAwaiter
+    {
+        fs::path file;
+        std::vector<uint8_t> data = {};
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        std::vector<uint8_t> await_resume() { return std::move(data); }
+    };
+
+public:
+    static void destroy();
+    // Called once per frame on the main thread
+    static void update();
+
+    // Continues on a worker thread
+    static WorkerAwaiter resumeOnWorker() { return {}; }
+    // Continues on the main thread at the start of the next frame
+    static FrameAwaiter nextFrame() { return {}; }
+    // Continues on the main thread once everything submitted to RenderContext during the current frame finished
+    static FrameFinishedAwaiter frameFinished();
+    // Continues on the worker thread that finished job
+    static JobAwaiter wait(const ThreadPool::JobHandle& job) { return { job }; }
+    // Reads the whole file on a worker thread, continues on the main thread at the start of the next frame
+    static FileAwaiter readFile(const fs::path& file) { return { file }; }
+
+private:
+    static void post(std::coroutine_handle<> handle);
+
+private:
+    static inline std::mutex mux;
+    static inline std::vector<std::coroutine_handle<>> frame_continuations = {};
+    static inline std::vector<std::pair<uint64_t, std::coroutine_handle<>>> frame_finished_continuations = {};
+};
\ No newline at end of file
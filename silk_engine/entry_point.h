@@ -21,6 +21,7 @@ int Main(int argc, char** argv)
 	{
 		SK_CRITICAL("Exception: {}", e.what());
 	}
+	Log::destroy();
 	return 0;
 }
 
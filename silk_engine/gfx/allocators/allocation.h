@@ -19,7 +19,8 @@ public:
 	{
 		AUTO = VMA_MEMORY_USAGE_AUTO,
 		GPU = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
-		CPU = VMA_MEMORY_USAGE_AUTO_PREFER_HOST
+		CPU = VMA_MEMORY_USAGE_AUTO_PREFER_HOST,
+		LAZY = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED // Transient attachments only
 	};
 
 	struct Props
@@ -4,6 +4,7 @@
 #include "silk_engine/gfx/instance.h"
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/devices/physical_device.h"
+#include "silk_engine/utils/memory_tracker.h"
 
 Allocator::Allocator(const LogicalDevice& logical_device)
 {
@@ -12,6 +13,7 @@ Allocator::Allocator(const LogicalDevice& logical_device)
 	allocator_info.instance = logical_device.getPhysicalDevice().getInstance();
 	allocator_info.physicalDevice = logical_device.getPhysicalDevice();
 	allocator_info.device = logical_device;
+	allocator_info.pAllocationCallbacks = RenderContext::getAllocationCallbacks();
 	allocator_info.flags = logical_device.hasExtension(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME) * VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT;
 	vmaCreateAllocator(&allocator_info, &allocator);
 }
@@ -40,24 +42,77 @@ VkMemoryPropertyFlags Allocator::getAllocationMemoryProperties(VmaAllocation all
 
 Allocation Allocator::allocateBuffer(const VkBufferCreateInfo& buffer_create_info, const VmaAllocationCreateInfo& alloc_ci, VkBuffer& buffer) const
 {
+	VmaAllocationCreateInfo tagged_alloc_ci = alloc_ci;
+	tagged_alloc_ci.pUserData = getMemoryTag(MemoryTracker::Tag::BUFFERS);
 	VmaAllocation alloc = nullptr;
-	RenderContext::vulkanAssert(vmaCreateBuffer(allocator, &buffer_create_info, &alloc_ci, &buffer, &alloc, nullptr));
+	RenderContext::vulkanAssert(vmaCreateBuffer(allocator, &buffer_create_info, &tagged_alloc_ci, &buffer, &alloc, nullptr));
+	trackAllocation(alloc);
 	return Allocation(alloc);
 }
 
 Allocation Allocator::allocateImage(const VkImageCreateInfo& image_create_info, const VmaAllocationCreateInfo& alloc_ci, VkImage& image) const
 {
+	VmaAllocationCreateInfo tagged_alloc_ci = alloc_ci;
+	tagged_alloc_ci.pUserData = getMemoryTag(MemoryTracker::Tag::IMAGES);
 	VmaAllocation alloc = nullptr;
-	RenderContext::vulkanAssert(vmaCreateImage(allocator, &image_create_info, &alloc_ci, &image, &alloc, nullptr));
+	RenderContext::vulkanAssert(vmaCreateImage(allocator, &image_create_info, &tagged_alloc_ci, &image, &alloc, nullptr));
+	trackAllocation(alloc);
 	return Allocation(alloc);
 }
 
+Allocation Allocator::allocateMemory(const VkMemoryRequirements& memory_requirements, const VmaAllocationCreateInfo& alloc_ci) const
+{
+	VmaAllocationCreateInfo tagged_alloc_ci = alloc_ci;
+	tagged_alloc_ci.pUserData = getMemoryTag(MemoryTracker::Tag::IMAGES);
+	VmaAllocation alloc = nullptr;
+	RenderContext::vulkanAssert(vmaAllocateMemory(allocator, &memory_requirements, &tagged_alloc_ci, &alloc, nullptr));
+	trackAllocation(alloc);
+	return Allocation(alloc);
+}
+
+void Allocator::bindImageMemory(VmaAllocation allocation, VkImage image) const
+{
+	RenderContext::vulkanAssert(vmaBindImageMemory(allocator, allocation, image));
+}
+
+void Allocator::freeMemory(VmaAllocation allocation) const
+{
+	trackFree(allocation);
+	vmaFreeMemory(allocator, allocation);
+}
+
 void Allocator::destroyBuffer(VkBuffer buffer, VmaAllocation allocation) const
 {
+	trackFree(allocation);
 	vmaDestroyBuffer(allocator, buffer, allocation);
 }
 
 void Allocator::destroyImage(VkImage image, VmaAllocation allocation) const
 {
+	trackFree(allocation);
 	vmaDestroyImage(allocator, image, allocation);
 }
+
+void* Allocator::getMemoryTag(MemoryTracker::Tag fallback)
+{
+	MemoryTracker::Tag tag = MemoryTracker::getTag();
+	return (void*)uintptr_t(tag == MemoryTracker::Tag::GENERAL ? fallback : tag);
+}
+
+void Allocator::trackAllocation(VmaAllocation allocation) const
+{
+	if (!allocation)
+		return;
+	VmaAllocationInfo info{};
+	vmaGetAllocationInfo(allocator, allocation, &info);
+	MemoryTracker::recordAllocation(MemoryTracker::Tag(uintptr_t(info.pUserData)), MemoryTracker::Domain::DEVICE, info.size);
+}
+
+void Allocator::trackFree(VmaAllocation allocation) const
+{
+	if (!allocation)
+		return;
+	VmaAllocationInfo info{};
+	vmaGetAllocationInfo(allocator, allocation, &info);
+	MemoryTracker::recordFree(MemoryTracker::Tag(uintptr_t(info.pUserData)), MemoryTracker::Domain::DEVICE, info.size);
+}
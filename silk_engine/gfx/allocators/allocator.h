@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vk_mem_alloc.h>
+#include "silk_engine/utils/memory_tracker.h"
 
 class LogicalDevice;
 class Allocation;
@@ -17,11 +18,21 @@ public:
 
 	Allocation allocateBuffer(const VkBufferCreateInfo& buffer_create_info, const VmaAllocationCreateInfo& alloc_ci, VkBuffer& buffer) const;
 	Allocation allocateImage(const VkImageCreateInfo& image_create_info, const VmaAllocationCreateInfo& alloc_ci, VkImage& image) const;
+	// Memory that isn't bound yet, so several resources can be bound to it
+	Allocation allocateMemory(const VkMemoryRequirements& memory_requirements, const VmaAllocationCreateInfo& alloc_ci) const;
+	void bindImageMemory(VmaAllocation allocation, VkImage image) const;
+	void freeMemory(VmaAllocation allocation) const;
 	void destroyBuffer(VkBuffer buffer, VmaAllocation allocation) const;
 	void destroyImage(VkImage image, VmaAllocation allocation) const;
 
 	operator const VmaAllocator& () const { return allocator; }
 
+private:
+	// Calling thread's tag, or fallback if it has none, stored as the allocation's user data
+	static void* getMemoryTag(MemoryTracker::Tag fallback);
+	void trackAllocation(VmaAllocation allocation) const;
+	void trackFree(VmaAllocation allocation) const;
+
 private:
 	VmaAllocator allocator = nullptr;
 };
\ No newline at end of file
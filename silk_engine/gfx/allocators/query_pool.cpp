@@ -46,6 +46,16 @@ void QueryPool::end(uint32_t index)
 	queries[index] = false;
 }
 
+void QueryPool::writeTimestamp(PipelineStage stage, uint32_t index)
+{
+	RenderContext::getCommandBuffer().writeTimestamp(stage, query_pool, index);
+}
+
+void QueryPool::reset(uint32_t first, uint32_t count)
+{
+	RenderContext::getLogicalDevice().resetQueryPool(query_pool, first, count);
+}
+
 uint64_t QueryPool::getOcclusionResult(uint32_t index, bool wait)
 {
 	std::vector<uint32_t> results = RenderContext::getLogicalDevice().getQueryPoolResults(query_pool, index, 1, sizeof(uint64_t), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT | (wait * VK_QUERY_RESULT_WAIT_BIT));
@@ -70,3 +80,19 @@ std::vector<uint32_t> QueryPool::getResults(uint32_t index, bool wait)
 	uint32_t data_size = data_count * sizeof(uint32_t);
 	return RenderContext::getLogicalDevice().getQueryPoolResults(query_pool, index, 1, data_size, data_size, wait * VK_QUERY_RESULT_WAIT_BIT);
 }
+
+bool QueryPool::getTimestamps(uint32_t first, std::span<uint64_t> timestamps)
+{
+	// Every query writes its value followed by its availability
+	constexpr size_t stride = 2 * sizeof(uint64_t);
+	std::vector<uint32_t> results = RenderContext::getLogicalDevice().getQueryPoolResults(query_pool, first, timestamps.size(), timestamps.size() * stride, stride, VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	bool available = true;
+	for (size_t i = 0; i < timestamps.size(); ++i)
+	{
+		uint64_t result[2] = {};
+		memcpy(result, rcast<const uint8_t*>(results.data()) + i * stride, stride);
+		timestamps[i] = result[1] ? result[0] : 0;
+		available &= result[1] != 0;
+	}
+	return available;
+}
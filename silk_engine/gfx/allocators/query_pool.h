@@ -36,9 +36,17 @@ public:
 
 	void begin(uint32_t index = 0);
 	void end(uint32_t index = 0);
+	void writeTimestamp(PipelineStage stage, uint32_t index = 0);
+	// Resets from the host, queries must not be in use by pending commands
+	void reset(uint32_t first = 0, uint32_t count = 1);
 
 	uint64_t getOcclusionResult(uint32_t index = 0, bool wait = false);
 	std::vector<uint32_t> getResults(uint32_t index = 0, bool wait = false);
+	// Doesn't wait, timestamps that aren't available yet are left 0
+	// @return whether all timestamps were available
+	bool getTimestamps(uint32_t first, std::span<uint64_t> timestamps);
+	uint32_t getCount() const { return queries.size(); }
+	PipelineStatistics getPipelineStatistics() const { return pipeline_statistics; }
 
 	operator const VkQueryPool& () const { return query_pool; }
 
@@ -13,7 +13,7 @@ Buffer::Buffer(VkDeviceSize size, BufferUsage usage, const Allocation::Props& al
 
 Buffer::~Buffer()
 {
-	RenderContext::getAllocator().destroyBuffer(buffer, allocation);
+	destroy();
 }
 
 void Buffer::resize(VkDeviceSize size)
@@ -21,7 +21,7 @@ void Buffer::resize(VkDeviceSize size)
 	if (size == ci.size)
 		return;
 	ci.size = size;
-	RenderContext::getAllocator().destroyBuffer(buffer, allocation);
+	destroy();
 	allocation = RenderContext::getAllocator().allocateBuffer(ci, alloc_ci, buffer);
 }
 
@@ -35,6 +35,12 @@ void Buffer::reallocate(VkDeviceSize size)
 	setData(data.data(), data.size());
 }
 
+void Buffer::destroy()
+{
+	// Frames in flight may still read it
+	RenderContext::destroyDeferred([buffer = buffer, allocation = VmaAllocation(allocation)] { RenderContext::getAllocator().destroyBuffer(buffer, allocation); });
+}
+
 void Buffer::copy(VkBuffer destination, VkDeviceSize size, VkDeviceSize offset, VkDeviceSize dst_offset) const
 {
 	copy(destination, buffer, size ? size : (ci.size - offset), dst_offset, offset);
@@ -42,6 +42,9 @@ public:
 protected:
 	static void barrier(const VkBuffer& buffer, VkAccessFlags source_access_mask, VkAccessFlags destination_access_mask, PipelineStage source_stage, PipelineStage destination_stage, VkDeviceSize offset, VkDeviceSize size);
 
+private:
+	void destroy();
+
 protected:
 	VkBuffer buffer = nullptr;
 	VkBufferCreateInfo ci;
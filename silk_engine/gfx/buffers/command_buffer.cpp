@@ -24,17 +24,37 @@ CommandBuffer::~CommandBuffer()
 
 #pragma region Begin/End
 void CommandBuffer::begin(VkCommandBufferUsageFlags usage)
+{
+	VkCommandBufferInheritanceInfo inheritance_info{};
+	inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	begin(usage, inheritance_info);
+}
+
+void CommandBuffer::begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo& inheritance_info)
 {
 	if (*state == State::RECORDING)
 		return;
 
-	//TODO: Inheritance info and secondary command buffers
-
 	VkCommandBufferBeginInfo begin_info{};
 	begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	begin_info.flags = usage;
+	if (!is_primary)
+	{
+		begin_info.pInheritanceInfo = &inheritance_info;
+		if (inheritance_info.renderPass)
+			begin_info.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	}
 	vkBeginCommandBuffer(command_buffer, &begin_info);
 	*state = State::RECORDING;
+
+	// Nothing is bound in a new recording, a secondary continuing a subpass is already inside its render pass
+	active = {};
+	if (!is_primary && inheritance_info.renderPass)
+	{
+		active.render_pass = inheritance_info.renderPass;
+		active.subpass = inheritance_info.subpass;
+		active.framebuffer = inheritance_info.framebuffer;
+	}
 }
 
 void CommandBuffer::end()
@@ -423,9 +443,18 @@ void CommandBuffer::setPrimitiveRestartEnable(VkBool32 primitive_restart_enable)
 #pragma endregion 
 
 #pragma region Commands
-void CommandBuffer::executeCommands(const std::vector<VkCommandBuffer>& command_buffers) const
+void CommandBuffer::executeCommands(const std::vector<VkCommandBuffer>& command_buffers)
 {
 	vkCmdExecuteCommands(command_buffer, command_buffers.size(), command_buffers.data());
+
+	// Bound and dynamic state is undefined after executing secondaries, only the render pass instance carries over
+	Active previous = std::move(active);
+	active = {};
+	active.render_pass = previous.render_pass;
+	active.framebuffer = previous.framebuffer;
+	active.render_area = previous.render_area;
+	active.subpass = previous.subpass;
+	active.query_pool = previous.query_pool;
 }
 
 void CommandBuffer::copyBuffer(VkBuffer source, VkBuffer destination, const std::vector<VkBufferCopy>& copy_regions) const
@@ -458,6 +487,11 @@ void CommandBuffer::resetQueryPool(VkQueryPool query_pool, uint32_t first, uint3
 	vkCmdResetQueryPool(command_buffer, query_pool, first, count);
 }
 
+void CommandBuffer::writeTimestamp(PipelineStage stage, VkQueryPool query_pool, uint32_t query) const
+{
+	vkCmdWriteTimestamp(command_buffer, VkPipelineStageFlagBits(ecast(stage)), query_pool, query);
+}
+
 void CommandBuffer::blitImage(VkImage source, VkImageLayout source_layout, VkImage destination, VkImageLayout destination_layout, const std::vector<VkImageBlit>& blit_regions, VkFilter filter) const
 {
 	vkCmdBlitImage(command_buffer, source, source_layout, destination, destination_layout, blit_regions.size(), blit_regions.data(), filter);
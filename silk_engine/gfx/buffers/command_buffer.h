@@ -45,6 +45,8 @@ public:
 	~CommandBuffer();
 
 	void begin(VkCommandBufferUsageFlags usage = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	// Secondary command buffers continue the subpass of inheritance_info when it has a render pass
+	void begin(VkCommandBufferUsageFlags usage, const VkCommandBufferInheritanceInfo& inheritance_info);
 	void end();
 	void beginQuery(VkQueryPool query_pool, uint32_t query, VkQueryControlFlags flags);
 	void endQuery(VkQueryPool query_pool, uint32_t query);
@@ -90,13 +92,14 @@ public:
 	void setDepthBiasEnable(VkBool32 depth_bias_enable);
 	void setPrimitiveRestartEnable(VkBool32 primitive_restart_enable);
 	
-	void executeCommands(const std::vector<VkCommandBuffer>& command_buffers) const;
+	void executeCommands(const std::vector<VkCommandBuffer>& command_buffers);
 	void copyBuffer(VkBuffer source, VkBuffer destination, const std::vector<VkBufferCopy>& copy_regions) const;
 	void pipelineBarrier(PipelineStage source_stage, PipelineStage destination_stage, VkDependencyFlags dependency, const std::vector<VkMemoryBarrier>& memory_barriers, const std::vector<VkBufferMemoryBarrier>& buffer_barriers, const std::vector<VkImageMemoryBarrier>& image_barriers) const;
 	void setEvent(VkEvent event, PipelineStage stage) const;
 	void resetEvent(VkEvent event, PipelineStage stage) const;
 	void waitEvents(const std::vector<VkEvent>& events, PipelineStage source_stage, PipelineStage destination_stage, VkDependencyFlags dependency, const std::vector<VkMemoryBarrier>& memory_barriers, const std::vector<VkBufferMemoryBarrier>& buffer_barriers, const std::vector<VkImageMemoryBarrier>& image_barriers) const;
 	void resetQueryPool(VkQueryPool query_pool, uint32_t first, uint32_t count) const;
+	void writeTimestamp(PipelineStage stage, VkQueryPool query_pool, uint32_t query) const;
 	void blitImage(VkImage source, VkImageLayout source_layout, VkImage destination, VkImageLayout destination_layout, const std::vector<VkImageBlit>& blit_regions, VkFilter filter = VK_FILTER_LINEAR) const;
 	void copyBufferToImage(VkBuffer buffer, VkImage image, VkImageLayout image_layout, const std::vector<VkBufferImageCopy>& copy_regions) const;
 	void copyImageToBuffer(VkImage image, VkImageLayout image_layout, VkBuffer buffer, const std::vector<VkBufferImageCopy>& copy_regions) const;
@@ -3,6 +3,7 @@
 #include "silk_engine/gfx/window/window.h"
 #include "silk_engine/gfx/window/swap_chain.h"
 #include "silk_engine/gfx/devices/logical_device.h"
+#include "silk_engine/gfx/devices/physical_device.h"
 #include "silk_engine/gfx/pipeline/render_pass.h"
 
 Framebuffer::Framebuffer(const SwapChain& swap_chain, const RenderPass& render_pass, uint32_t width, uint32_t height, bool imageless) :
@@ -13,40 +14,68 @@ Framebuffer::Framebuffer(const SwapChain& swap_chain, const RenderPass& render_p
     width(width),
     height(height)
 {
-    for (size_t attachment = 0; attachment < render_pass.getAttachmentDescriptions().size(); ++attachment)
+    bool lazy_memory = RenderContext::getPhysicalDevice().supportsLazilyAllocatedMemory();
+    const auto& attachment_descs = render_pass.getAttachmentDescriptions();
+    std::vector<shared<Image>> images(attachment_descs.size());
+    std::vector<Image::Props> images_props(attachment_descs.size());
+    for (size_t attachment = 0; attachment < attachment_descs.size(); ++attachment)
     {
-        const auto& attachment_desc = render_pass.getAttachmentDescriptions()[attachment];
+        const auto& attachment_desc = attachment_descs[attachment];
         if (attachment_desc.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+            continue;
+
+        // TODO: Remove hardcodes
+        Image::Props& image_props = images_props[attachment];
+        image_props.format = Format(attachment_desc.format);
+        image_props.width = width;
+        image_props.height = height;
+        image_props.sampler_props.mipmap_mode = MipmapMode::NONE;
+        image_props.samples = attachment_desc.samples;
+        image_props.allocation_props.preferred_device = Allocation::Device::GPU;
+        image_props.allocation_props.priority = 1.0f;
+        image_props.usage = isDepthStencilFormat(Format(attachment_desc.format)) ? ImageUsage::DEPTH_STENCIL_ATTACHMENT : ImageUsage::COLOR_ATTACHMENT;
+        // Transient attachments are never sampled, so they can live in lazily allocated memory that tilers don't back at all
+        if (render_pass.isTransient(attachment))
+        {
+            image_props.usage |= ImageUsage::TRANSIENT_ATTACHMENT;
+            if (lazy_memory)
+                image_props.allocation_props.preferred_device = Allocation::Device::LAZY;
+        }
+        else
+            image_props.usage |= ImageUsage::SAMPLED;
+        if (render_pass.isInputAttachment(attachment))
+            image_props.usage |= ImageUsage::INPUT_ATTACHMENT;
+    }
+
+    for (const auto& aliased : render_pass.getAliasedAttachments())
+    {
+        std::vector<Image::Props> aliased_props(aliased.size());
+        for (size_t i = 0; i < aliased.size(); ++i)
+            aliased_props[i] = images_props[aliased[i]];
+        std::vector<shared<Image>> aliased_images = Image::createAliased(aliased_props);
+        for (size_t i = 0; i < aliased.size(); ++i)
+            images[aliased[i]] = std::move(aliased_images[i]);
+    }
+
+    for (size_t attachment = 0; attachment < attachment_descs.size(); ++attachment)
+    {
+        const auto& attachment_desc = attachment_descs[attachment];
+        if (attachment_desc.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR)
+        {
             for (size_t i = 0; i < swap_chain.getImages().size(); ++i)
                 attachments[i].emplace_back(swap_chain.getImages()[i]);
-        else
-        { 
-            // TODO: Remove hardcodes
-            Image::Props image_props{};
-            image_props.format = Format(attachment_desc.format);
-            image_props.width = width;
-            image_props.height = height;
-            image_props.sampler_props.mipmap_mode = MipmapMode::NONE;
-            image_props.samples = attachment_desc.samples;
-            image_props.allocation_props.preferred_device = Allocation::Device::GPU;
-            image_props.allocation_props.priority = 1.0f;
-            image_props.usage = isDepthStencilFormat(Format(attachment_desc.format)) ? ImageUsage::DEPTH_STENCIL_ATTACHMENT : ImageUsage::COLOR_ATTACHMENT;
-            // NOTE: Not sure if this is correct
-            if (attachment_desc.loadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE && attachment_desc.stencilLoadOp == VK_ATTACHMENT_LOAD_OP_DONT_CARE)
-            {
-                if (attachment_desc.storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE && attachment_desc.stencilStoreOp == VK_ATTACHMENT_STORE_OP_DONT_CARE)
-                    image_props.usage |= ImageUsage::TRANSIENT_ATTACHMENT;
-                else
-                    image_props.usage |= ImageUsage::SAMPLED;
-            }
-            if (render_pass.isInputAttachment(attachment))
-                image_props.usage |= ImageUsage::INPUT_ATTACHMENT;
-            
-            shared<Image> image = makeShared<Image>(image_props);
-            image->setLayout(attachment_desc.finalLayout);
-            for (size_t i = 0; i < framebuffers.size(); ++i)
-                attachments[i].emplace_back(image);
+            continue;
         }
+
+        shared<Image>& image = images[attachment];
+        if (!image)
+            image = makeShared<Image>(images_props[attachment]);
+        // Loaded attachments start the render pass in their final layout, so new images are moved there once
+        if (attachment_desc.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+            image->transitionLayout(attachment_desc.initialLayout);
+        image->setLayout(attachment_desc.finalLayout);
+        for (size_t i = 0; i < framebuffers.size(); ++i)
+            attachments[i].emplace_back(image);
     }
 
     for (size_t i = 0; i < framebuffers.size(); ++i)
@@ -30,6 +30,12 @@ CommandBuffer& CommandQueue::getNewCommandBuffer(bool begin)
 	return *command_buffer;
 }
 
+CommandBuffer& CommandQueue::getNewSecondaryCommandBuffer()
+{
+	if (secondary_index >= secondary_command_buffers.size())
+		secondary_command_buffers.emplace_back(makeShared<CommandBuffer>(*command_pool, VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+	return *secondary_command_buffers[secondary_index++];
+}
 
 const shared<CommandBuffer>& CommandQueue::submit(const std::vector<PipelineStage>& wait_stages, const std::vector<VkSemaphore>& wait_semaphores, const std::vector<VkSemaphore>& signal_semaphores)
 {
@@ -51,11 +57,15 @@ void CommandQueue::reset()
 			needs_rest = true;
 			break;
 		}
+	needs_rest |= secondary_index > 0;
 	if (needs_rest)
 	{
 		command_pool->reset();
 		for (const auto& command_buffer : command_buffers)
 			command_buffer->reset();
+		for (const auto& command_buffer : secondary_command_buffers)
+			command_buffer->reset();
 	}
 	index = 0;
+	secondary_index = 0;
 }
\ No newline at end of file
@@ -11,6 +11,8 @@ public:
 
 	CommandBuffer& getCommandBuffer(bool begin = true);
 	CommandBuffer& getNewCommandBuffer(bool begin = true);
+	// Not begun yet, so the caller can begin it with the inheritance of the subpass it continues
+	CommandBuffer& getNewSecondaryCommandBuffer();
 
 	const shared<CommandBuffer>& submit(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {});
 	void execute(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {});
@@ -21,4 +23,6 @@ private:
 	shared<CommandPool> command_pool = nullptr;
 	std::vector<shared<CommandBuffer>> command_buffers;
 	size_t index = 0;
+	std::vector<shared<CommandBuffer>> secondary_command_buffers;
+	size_t secondary_index = 0;
 };
\ No newline at end of file
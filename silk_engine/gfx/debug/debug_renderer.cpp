@@ -1,4 +1,5 @@
 #include "debug_renderer.h"
+#include "silk_engine/utils/memory_tracker.h"
 #include "silk_engine/gfx/pipeline/graphics_pipeline.h"
 #include "silk_engine/gfx/descriptors/descriptor_set.h"
 #include "silk_engine/scene/meshes/mesh.h"
@@ -19,12 +20,11 @@
 #include "silk_engine/gfx/ui/font.h"
 #include "silk_engine/gfx/buffers/buffer.h"
 #include "silk_engine/gfx/render_context.h"
-#include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/pipeline/render_graph/render_graph.h"
 #include "silk_engine/gfx/pipeline/material.h"
 #include "silk_engine/gfx/pipeline/render_pass.h"
 
-shared<Buffer> DebugRenderer::global_uniform_buffer = nullptr;
+std::array<shared<Buffer>, RenderContext::MAX_FRAMES> DebugRenderer::global_uniform_buffers{};
 std::array<Light, DebugRenderer::MAX_LIGHTS> DebugRenderer::lights{};
 shared<Image> DebugRenderer::white_image = nullptr;
 shared<GraphicsPipeline> DebugRenderer::graphics_pipeline_2D = nullptr;
@@ -32,43 +32,49 @@ shared<GraphicsPipeline> DebugRenderer::graphics_pipeline_3D = nullptr;
 
 void DebugRenderer::InstancedRendererBase::InstanceGroup::bind()
 {
-	material->set("GlobalUniform", *global_uniform_buffer);
+	material->set("GlobalUniform", *getGlobalUniformBuffer());
 	material->set("images", instance_images.getDescriptorImageInfos());
 	material->bind();
 	mesh->bind();
-	instance_buffer->bindVertex(1);
+	instance_buffers[RenderContext::getFrame()]->bindVertex(1);
 }
 
 void DebugRenderer::InstancedRendererBase::init()
 {
-	indirect_buffer = makeShared<Buffer>(256 * sizeof(VkDrawIndexedIndirectCommand), BufferUsage::INDIRECT, Allocation::Props{ Allocation::MAPPED | Allocation::RANDOM_ACCESS });
+	for (auto& indirect_buffer : indirect_buffers)
+		indirect_buffer = makeShared<Buffer>(256 * sizeof(VkDrawIndexedIndirectCommand), BufferUsage::INDIRECT, Allocation::Props{ Allocation::MAPPED | Allocation::RANDOM_ACCESS });
 }
 
 void DebugRenderer::InstancedRendererBase::update()
 {
+	// Only this frame's buffers are written, RenderContext::update waited until the GPU was done with them
+	size_t frame = RenderContext::getFrame();
 	bool any_needs_update = false;
 	draw_commands.resize(instance_batches.size());
 
 	for (size_t i = 0; i < instance_batches.size(); ++i)
 	{
 		auto& instance_batch = instance_batches[i];
-		if (instance_batch.needs_update && instance_batch.instance_count)
+		if (instance_batch.needs_update[frame] && instance_batch.instance_count)
 		{
-			instance_batch.needs_update = false;
-			if (!any_needs_update)
-				RenderContext::getLogicalDevice().wait();
+			instance_batch.needs_update[frame] = false;
 			any_needs_update = true;
 			draw_commands[i].instanceCount = instance_batch.instance_count;
 			draw_commands[i].firstIndex = instance_batch.first_index;
 			draw_commands[i].indexCount = instance_batch.index_count;
-			if (instance_batch.instance_data.size() > instance_batch.instance_buffer->getSize())
-				instance_batch.instance_buffer->resize(instance_batch.instance_data.size() * 2);
-			instance_batch.instance_buffer->setData(instance_batch.instance_data.data(), instance_batch.instance_data.size());
+			const shared<Buffer>& instance_buffer = instance_batch.instance_buffers[frame];
+			if (instance_batch.instance_data.size() > instance_buffer->getSize())
+				instance_buffer->resize(instance_batch.instance_data.size() * 2);
+			instance_buffer->setData(instance_batch.instance_data.data(), instance_batch.instance_data.size());
 		}
 	}
 
-	if (any_needs_update && !indirect_buffer->setData(draw_commands.data(), draw_commands.size() * sizeof(VkDrawIndexedIndirectCommand)))
+	if (!any_needs_update)
+		return;
+	const shared<Buffer>& indirect_buffer = indirect_buffers[frame];
+	while (draw_commands.size() * sizeof(VkDrawIndexedIndirectCommand) > indirect_buffer->getSize())
 		indirect_buffer->resize(indirect_buffer->getSize() * 2);
+	indirect_buffer->setData(draw_commands.data(), draw_commands.size() * sizeof(VkDrawIndexedIndirectCommand));
 }
 
 void DebugRenderer::InstancedRendererBase::render()
@@ -77,7 +83,7 @@ void DebugRenderer::InstancedRendererBase::render()
 	for (auto& instance_batch : instance_batches)
 	{
 		instance_batch.bind();
-		indirect_buffer->drawIndexedIndirect(draw_index);
+		indirect_buffers[RenderContext::getFrame()]->drawIndexedIndirect(draw_index);
 		++draw_index;
 	}
 }
@@ -110,7 +116,8 @@ DebugRenderer::Renderable DebugRenderer::InstancedRendererBase::createInstance(c
 		new_batch.data_size = instance_data_size;
 		new_batch.addData(instance_data);
 		new_batch.material = makeShared<Material>(pipeline);
-		new_batch.instance_buffer = makeShared<Buffer>(65536, BufferUsage::VERTEX, Allocation::Props{ Allocation::SEQUENTIAL_WRITE | Allocation::MAPPED });
+		for (auto& instance_buffer : new_batch.instance_buffers)
+			instance_buffer = makeShared<Buffer>(65536, BufferUsage::VERTEX, Allocation::Props{ Allocation::SEQUENTIAL_WRITE | Allocation::MAPPED });
 		new_batch.instance_images.add({ white_image });
 		new_batch.hash = hash;
 	}
@@ -126,43 +133,54 @@ DebugRenderer::Renderable DebugRenderer::InstancedRendererBase::createInstance(c
 	return Renderable(instance_data_index, instance_batch_index, image_index, images.size());
 }
 
-shared<DebugRenderer::Renderable> DebugRenderer::InstancedRenderer::createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, size_t image_index_offset, const shared<GraphicsPipeline>& pipeline, const std::vector<shared<Image>>& images)
+DebugRenderer::RenderableHandle DebugRenderer::InstancedRenderer::createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, size_t image_index_offset, const shared<GraphicsPipeline>& pipeline, const std::vector<shared<Image>>& images)
 {
 	Renderable instance = DebugRenderer::InstancedRendererBase::createInstance(mesh, first_index, index_count, instance_data, instance_data_size, image_index_offset, pipeline, images);
 	if (instance.batch_index >= instances.size())
 		instances.emplace_back();
-	auto& instance_vec = instances[instance.batch_index];
-	instance_vec.emplace_back(makeShared<Renderable>(std::move(instance)));
-	return instance_vec.back();
+	RenderableHandle handle = renderables.create(instance);
+	instances[instance.batch_index].emplace_back(handle);
+	return handle;
 }
 
-void DebugRenderer::InstancedRenderer::destroyInstance(const Renderable& instance)
+void DebugRenderer::InstancedRenderer::destroyInstance(RenderableHandle handle)
 {
-	auto& instance_batch = instance_batches[instance.batch_index];
-	if (instance_batch.instance_data.empty())
+	const Renderable* renderable = renderables.get(handle);
+	if (!renderable)
 		return;
+	Renderable instance = *renderable;
+	renderables.destroy(handle);
 
-	if (instance_batch.instance_data.size() == 1)
+	auto& instance_batch = instance_batches[instance.batch_index];
+	auto& batch_instances = instances[instance.batch_index];
+	if (instance_batch.instance_count == 1)
 	{
 		if (instance.batch_index < instance_batches.size() - 1)
 		{
 			std::swap(instance_batch, instance_batches.back());
-			for (auto& i : instances.back())
-				i->batch_index = instance.batch_index;
+			std::swap(batch_instances, instances.back());
+			for (RenderableHandle moved : batch_instances)
+				renderables.get(moved)->batch_index = instance.batch_index;
+			instance_batch.needs_update.fill(true);
 		}
 		instance_batches.pop_back();
+		instances.pop_back();
 		return;
 	}
 
+	// Move the last instance into the freed slot, so instance data stays packed
 	instance_batch.instance_images.remove(instance.image_index, instance.image_count);
-	std::swap_ranges(instance_batch.instance_data.begin() + instance.data_offset, instance_batch.instance_data.begin() + instance.data_offset + instance_batch.data_size, instance_batch.instance_data.end() - instance_batch.data_size);
-	instance_batch.instance_data.erase(instance_batch.instance_data.end() - instance_batch.data_size);
+	size_t last_offset = instance_batch.instance_data.size() - instance_batch.data_size;
+	if (instance.data_offset != last_offset)
+	{
+		std::copy_n(instance_batch.instance_data.begin() + last_offset, instance_batch.data_size, instance_batch.instance_data.begin() + instance.data_offset);
+		renderables.get(batch_instances.back())->data_offset = instance.data_offset;
+		batch_instances[instance.data_offset / instance_batch.data_size] = batch_instances.back();
+	}
+	instance_batch.instance_data.resize(last_offset);
+	batch_instances.pop_back();
 	--instance_batch.instance_count;
-	instance_batch.needs_update = true;
-
-	instances[instance.batch_index].back()->data_offset = instance.data_offset;
-	std::swap(instances[instance.batch_index][instance.data_offset], instances[instance.batch_index].back());
-	instances[instance.batch_index].pop_back();
+	instance_batch.needs_update.fill(true);
 }
 
 void DebugRenderer::ImmediateInstancedRenderer::createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, size_t image_index_offset, const shared<GraphicsPipeline>& pipeline, const std::vector<shared<Image>>& images)
@@ -176,9 +194,11 @@ void DebugRenderer::ImmediateInstancedRenderer::createInstance(const shared<Mesh
 
 void DebugRenderer::init()
 {
+	MemoryTracker::Scope memory_scope(MemoryTracker::Tag::DEBUG_RENDERER);
 	render_context.init();
 	immediate_render_context.init();
-	global_uniform_buffer = makeShared<Buffer>(sizeof(GlobalUniformData), BufferUsage::UNIFORM | BufferUsage::TRANSFER_DST, Allocation::Props{ Allocation::MAPPED | Allocation::SEQUENTIAL_WRITE });
+	for (auto& global_uniform_buffer : global_uniform_buffers)
+		global_uniform_buffer = makeShared<Buffer>(sizeof(GlobalUniformData), BufferUsage::UNIFORM | BufferUsage::TRANSFER_DST, Allocation::Props{ Allocation::MAPPED | Allocation::SEQUENTIAL_WRITE });
 
 	VkRenderPass render_pass = RenderContext::getRenderGraph().getPass("Geometry").getRenderPass();
 
@@ -254,7 +274,7 @@ void DebugRenderer::destroy()
 	render_context.destroy();
 	immediate_render_context.destroy();
 	active = {};
-	global_uniform_buffer = nullptr;
+	global_uniform_buffers = {};
 	graphics_pipeline_2D = nullptr;
 	graphics_pipeline_3D = nullptr;
 	white_image = nullptr;
@@ -265,11 +285,13 @@ void DebugRenderer::reset()
 	immediate_render_context.clear();
 	active = {};
 	active.images = { white_image };
-	active.font = Font::get("Arial");
+	active.font = Font::get("Arial"_id);
 }
 
 void DebugRenderer::update(Camera* camera)
 {
+	SK_PROFILE_FUNCTION();
+	MemoryTracker::Scope memory_scope(MemoryTracker::Tag::DEBUG_RENDERER);
 	stats = {};
 
 	// Update uniforms
@@ -287,7 +309,7 @@ void DebugRenderer::update(Camera* camera)
 	global_uniform_data.frame = Time::frame;
 	global_uniform_data.resolution = uvec2(Window::get().getWidth(), Window::get().getHeight());
 	global_uniform_data.lights = lights;
-	global_uniform_buffer->setData(&global_uniform_data, sizeof(GlobalUniformData));
+	getGlobalUniformBuffer()->setData(&global_uniform_data, sizeof(GlobalUniformData));
 
 	render_context.update();
 	immediate_render_context.update();
@@ -295,6 +317,7 @@ void DebugRenderer::update(Camera* camera)
 
 void DebugRenderer::render()
 {
+	SK_PROFILE_FUNCTION();
 	render_context.render();
 	immediate_render_context.render();
 }
@@ -303,7 +326,7 @@ void DebugRenderer::render()
 
 void DebugRenderer::triangle(float x, float y, float width, float height)
 {
-	draw2D(Mesh::get("Triangle"), x, y, width, height);
+	draw2D(Mesh::get("Triangle"_id), x, y, width, height);
 }
 
 void DebugRenderer::triangle(float x, float y, float size)
@@ -318,12 +341,12 @@ void DebugRenderer::triangle(float x1, float y1, float x2, float y2, float x3, f
 
 void DebugRenderer::rectangle(float x, float y, float width, float height)
 {
-	draw2D(Mesh::get("Rectangle"), x, y, width, height);
+	draw2D(Mesh::get("Rectangle"_id), x, y, width, height);
 }
 
 void DebugRenderer::roundedRectangle(float x, float y, float width, float height)
 {
-	draw2D(Mesh::get("Rounded Rectangle"), x, y, width, height);
+	draw2D(Mesh::get("Rounded Rectangle"_id), x, y, width, height);
 }
 
 void DebugRenderer::square(float x, float y, float size)
@@ -333,17 +356,17 @@ void DebugRenderer::square(float x, float y, float size)
 
 void DebugRenderer::roundedSquare(float x, float y, float size)
 {
-	draw2D(Mesh::get("Rounded Rectangle"), x, y, size, size);
+	draw2D(Mesh::get("Rounded Rectangle"_id), x, y, size, size);
 }
 
 void DebugRenderer::ellipse(float x, float y, float width, float height)
 {
-	draw2D(Mesh::get("Circle"), x, y, width, height);
+	draw2D(Mesh::get("Circle"_id), x, y, width, height);
 }
 
 void DebugRenderer::ellipseOutline(float x, float y, float width, float height)
 {
-	draw2D(Mesh::get("Circle Outline"), x, y, width, height);
+	draw2D(Mesh::get("Circle Outline"_id), x, y, width, height);
 }
 
 void DebugRenderer::circle(float x, float y, float radius)
@@ -366,7 +389,7 @@ void DebugRenderer::line(float x1, float y1, float x2, float y2, float width)
 	float l = sqrt((x2 - x1) * (x2 - x1) + (y2 - y1) * (y2 - y1));
 	float dx = (x2 - x1) / l;
 	float dy = (y2 - y1) / l;
-	draw2D(Mesh::get("Rectangle"), {
+	draw2D(Mesh::get("Rectangle"_id), {
 			dx * l, dy * l, 0, 0,
 			-dy * width, dx * width, 0, 0,
 			0, 0, 1, 0,
@@ -399,13 +422,13 @@ void DebugRenderer::text(const std::string& text, float x, float y, float size)
 void DebugRenderer::image(const shared<Image>& image, float x, float y, float width, float height)
 {
 	active.images = { image };
-	draw2D(Mesh::get("Rectangle"), x, y, width, height);
+	draw2D(Mesh::get("Rectangle"_id), x, y, width, height);
 }
 
 void DebugRenderer::image(const shared<Image>& image, float x, float y, float size)
 {
 	active.images = { image };
-	draw2D(Mesh::get("Rectangle"), x, y, size, size);
+	draw2D(Mesh::get("Rectangle"_id), x, y, size, size);
 }
 
 void DebugRenderer::mesh(const shared<Mesh>& mesh, float x, float y, float width, float height)
@@ -415,27 +438,27 @@ void DebugRenderer::mesh(const shared<Mesh>& mesh, float x, float y, float width
 
 void DebugRenderer::tetrahedron(float x, float y, float z, float size)
 {
-	draw3D(Mesh::get("Tetrahedron"), x, y, z, size, size, size);
+	draw3D(Mesh::get("Tetrahedron"_id), x, y, z, size, size, size);
 }
 
 void DebugRenderer::cube(float x, float y, float z, float size)
 {
-	draw3D(Mesh::get("Cube"), x, y, z, size, size, size);
+	draw3D(Mesh::get("Cube"_id), x, y, z, size, size, size);
 }
 
 void DebugRenderer::cuboid(float x, float y, float z, float width, float height, float depth)
 {
-	draw3D(Mesh::get("Cube"), x, y, z, width, height, depth);
+	draw3D(Mesh::get("Cube"_id), x, y, z, width, height, depth);
 }
 
 void DebugRenderer::sphere(float x, float y, float z, float radius)
 {
-	draw3D(Mesh::get("Sphere"), x, y, z, radius, radius, radius);
+	draw3D(Mesh::get("Sphere"_id), x, y, z, radius, radius, radius);
 }
 
 void DebugRenderer::ellipsoid(float x, float y, float z, float width, float height, float depth)
 {
-	draw3D(Mesh::get("Sphere"), x, y, z, width, height, depth);
+	draw3D(Mesh::get("Sphere"_id), x, y, z, width, height, depth);
 }
 
 void DebugRenderer::mesh(const shared<Mesh>& mesh, float x, float y, float z, float width, float height, float depth)
@@ -472,6 +495,7 @@ void DebugRenderer::model(const shared<Model>& model, float x, float y, float z,
 
 void DebugRenderer::draw(const shared<GraphicsPipeline>& graphics_pipeline, const shared<Mesh>& mesh, const void* instance_data, size_t instance_data_size, uint32_t image_index_offset, const std::vector<shared<Image>>& images)
 {
+	MemoryTracker::Scope memory_scope(MemoryTracker::Tag::DEBUG_RENDERER);
 	immediate_render_context.createInstance(mesh, 0, mesh->getIndexCount(), instance_data, instance_data_size, image_index_offset, graphics_pipeline, images);
 }
 
@@ -4,6 +4,8 @@
 #include "silk_engine/scene/light.h"
 #include "silk_engine/scene/instance_images.h"
 #include "silk_engine/scene/camera/camera.h"
+#include "silk_engine/utils/object_pool.h"
+#include "silk_engine/gfx/render_context.h"
 
 class Image;
 class Font;
@@ -44,6 +46,7 @@ public:
 		size_t image_index = 0;
 		size_t image_count = 0;
 	};
+	using RenderableHandle = ObjectPool<Renderable>::Handle;
 
 private:
 	static inline struct Active
@@ -99,7 +102,7 @@ private:
 			void setData(size_t offset, const void* data)
 			{ 
 				memcpy(instance_data.data() + offset, data, data_size);
-				needs_update = true; 
+				needs_update.fill(true);
 			}
 			void addData(const void* data) 
 			{
@@ -121,9 +124,8 @@ private:
 			std::vector<uint8_t> instance_data{};
 			InstanceImages instance_images{};
 			shared<Material> material = nullptr;
-			shared<Buffer> instance_buffer = nullptr;
-			shared<Buffer> old_instance_buffer = nullptr;
-			bool needs_update = false;
+			std::array<shared<Buffer>, RenderContext::MAX_FRAMES> instance_buffers{}; // Per frame in flight, each is written while its frame is current
+			std::array<bool, RenderContext::MAX_FRAMES> needs_update{};
 			size_t instance_count = 0;
 			size_t data_size = 0;
 			size_t hash = 0;
@@ -134,7 +136,7 @@ private:
 		{
 			instance_batches.clear();
 			draw_commands.clear();
-			indirect_buffer = nullptr;
+			indirect_buffers = {};
 		}
 
 		void update();
@@ -149,7 +151,7 @@ private:
 		}
 
 	public:
-		shared<Buffer> indirect_buffer;
+		std::array<shared<Buffer>, RenderContext::MAX_FRAMES> indirect_buffers{};
 		std::vector<VkDrawIndexedIndirectCommand> draw_commands;
 		std::vector<InstanceGroup> instance_batches;
 	};
@@ -157,11 +159,17 @@ private:
 	class InstancedRenderer : public InstancedRendererBase
 	{
 	public:
-		shared<Renderable> createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, size_t image_index_offset = std::numeric_limits<size_t>::max(), const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {});
-		void destroyInstance(const Renderable& instance);
+		RenderableHandle createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, size_t image_index_offset = std::numeric_limits<size_t>::max(), const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {});
+		void updateInstance(RenderableHandle instance, const void* instance_data)
+		{
+			if (const Renderable* renderable = renderables.get(instance))
+				InstancedRendererBase::updateInstance(*renderable, instance_data);
+		}
+		void destroyInstance(RenderableHandle instance);
 
 	private:
-		std::vector<std::vector<shared<Renderable>>> instances;
+		ObjectPool<Renderable> renderables;
+		std::vector<std::vector<RenderableHandle>> instances; // Per batch, in instance data order
 	};
 
 	class ImmediateInstancedRenderer : public InstancedRendererBase
@@ -205,7 +213,7 @@ public:
 
 	static const Active& getActive() { return active; }
 	static const shared<Image>& getWhiteImage() { return white_image; }
-	static const shared<Buffer>& getGlobalUniformBuffer() { return global_uniform_buffer; }
+	static const shared<Buffer>& getGlobalUniformBuffer() { return global_uniform_buffers[RenderContext::getFrame()]; }
 
 	// States
 	static void transform(const mat4& transform = mat4(1)) { active.transformed = transform != mat4(1); active.transform = transform; }
@@ -253,16 +261,16 @@ public:
 
 	static Light* addLight(const Light& light);
 
-	static shared<Renderable> createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, uint32_t image_index_offset = std::numeric_limits<size_t>::max(), const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return render_context.createInstance(mesh, first_index, index_count, instance_data, instance_data_size, image_index_offset, pipeline, images); }
-	static shared<Renderable> createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const InstanceData2D& instance_data, const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return createInstance(mesh, first_index, index_count, &instance_data, sizeof(instance_data), offsetof(instance_data, image_index), pipeline, images); }
-	static shared<Renderable> createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const InstanceData3D& instance_data, const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return createInstance(mesh, first_index, index_count, &instance_data, sizeof(instance_data), offsetof(instance_data, image_index), pipeline, images); }
-	static void updateInstance(const Renderable& instance, const void* instance_data) { render_context.updateInstance(instance, instance_data); }
-	static void destroyInstance(const Renderable& instance) { render_context.destroyInstance(instance); }
+	static RenderableHandle createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const void* instance_data, size_t instance_data_size, uint32_t image_index_offset = std::numeric_limits<size_t>::max(), const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return render_context.createInstance(mesh, first_index, index_count, instance_data, instance_data_size, image_index_offset, pipeline, images); }
+	static RenderableHandle createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const InstanceData2D& instance_data, const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return createInstance(mesh, first_index, index_count, &instance_data, sizeof(instance_data), offsetof(instance_data, image_index), pipeline, images); }
+	static RenderableHandle createInstance(const shared<Mesh>& mesh, uint32_t first_index, uint32_t index_count, const InstanceData3D& instance_data, const shared<GraphicsPipeline>& pipeline = nullptr, const std::vector<shared<Image>>& images = {}) { return createInstance(mesh, first_index, index_count, &instance_data, sizeof(instance_data), offsetof(instance_data, image_index), pipeline, images); }
+	static void updateInstance(RenderableHandle instance, const void* instance_data) { render_context.updateInstance(instance, instance_data); }
+	static void destroyInstance(RenderableHandle instance) { render_context.destroyInstance(instance); }
 
 private:
 	static inline InstancedRenderer render_context;
 	static inline ImmediateInstancedRenderer immediate_render_context;
-	static shared<Buffer> global_uniform_buffer;
+	static std::array<shared<Buffer>, RenderContext::MAX_FRAMES> global_uniform_buffers;
 	static inline GlobalUniformData global_uniform_data{};
 	static std::array<Light, MAX_LIGHTS> lights;
 	static shared<Image> white_image;
@@ -0,0 +1,123 @@
+#include "gpu_profiler.h"
+#include "silk_engine/gfx/allocators/query_pool.h"
+#include "silk_engine/gfx/devices/logical_device.h"
+#include "silk_engine/gfx/buffers/command_buffer.h"
+#include "silk_engine/utils/frame_statistics.h"
+
+void GPUProfiler::init()
+{
+	const VkPhysicalDeviceLimits& limits = RenderContext::getPhysicalDevice().getProperties().limits;
+	supported = limits.timestampComputeAndGraphics;
+	if (!supported)
+	{
+		SK_WARN("GPU profiling is not supported, device doesn't support timestamps on all graphics and compute queues");
+		return;
+	}
+	timestamp_period = limits.timestampPeriod;
+
+	// Scopes are written from the graphics and compute queues, the one with fewer valid bits wraps first
+	const PhysicalDevice& physical_device = RenderContext::getPhysicalDevice();
+	timestamp_bits = 64;
+	for (uint32_t queue : { physical_device.getGraphicsQueue(), physical_device.getComputeQueue() })
+		if (queue < physical_device.getQueueFamilyProperties().size())
+			if (uint32_t bits = physical_device.getQueueFamilyProperties()[queue].timestampValidBits)
+				timestamp_bits = std::min(timestamp_bits, bits);
+
+	host_reset = RenderContext::getLogicalDevice().hasFeature(PhysicalDevice::Feature::HOST_QUERY_RESET);
+	track = Profiler::addTrack("GPU");
+	for (auto& frame : frames)
+	{
+		frame.query_pool = makeShared<QueryPool>(QueryPool::TIMESTAMP, MAX_SCOPES * 2);
+		if (host_reset)
+			frame.query_pool->reset(0, MAX_SCOPES * 2);
+	}
+}
+
+void GPUProfiler::destroy()
+{
+	frames = {};
+	supported = false;
+}
+
+void GPUProfiler::update()
+{
+	if (!supported)
+		return;
+
+	std::scoped_lock lock(mutex);
+	Frame& frame = frames[RenderContext::getFrame()];
+	if (frame.scopes.empty())
+		return;
+
+	std::vector<uint64_t> timestamps(frame.scopes.size() * 2);
+	if (frame.query_pool->getTimestamps(0, timestamps))
+	{
+		// Only the low timestamp_bits are valid and may wrap around mid frame, so ticks are taken relative to the
+		// first timestamp modulo 2^timestamp_bits and sign extended, scopes on another queue may have run before it
+		uint64_t mask = timestamp_bits >= 64 ? ~uint64_t(0) : (uint64_t(1) << timestamp_bits) - 1;
+		uint64_t sign = (mask >> 1) + 1;
+		uint64_t reference = timestamps[0];
+		std::vector<int64_t> ticks(timestamps.size());
+		for (size_t i = 0; i < timestamps.size(); ++i)
+		{
+			uint64_t relative = (timestamps[i] - reference) & mask;
+			ticks[i] = int64_t((relative ^ sign) - sign);
+		}
+
+		int64_t gpu_origin = std::numeric_limits<int64_t>::max();
+		int64_t gpu_end = std::numeric_limits<int64_t>::min();
+		for (size_t i = 0; i < ticks.size(); i += 2)
+		{
+			gpu_origin = std::min(gpu_origin, ticks[i]);
+			gpu_end = std::max(gpu_end, ticks[i + 1]);
+		}
+		FrameStatistics::record(FrameStatistics::GPU, (gpu_end - gpu_origin) * timestamp_period * 1e-6);
+		uint64_t cpu_origin = std::max(frame.recorded, last_end);
+
+		for (size_t i = 0; i < frame.scopes.size(); ++i)
+		{
+			uint64_t start = cpu_origin + uint64_t((ticks[i * 2] - gpu_origin) * timestamp_period);
+			uint64_t end = cpu_origin + uint64_t(std::max(ticks[i * 2 + 1] - gpu_origin, ticks[i * 2] - gpu_origin) * timestamp_period);
+			Profiler::record(track, frame.scopes[i], start, end);
+			last_end = std::max(last_end, end);
+		}
+	}
+	// Otherwise the frame is dropped, waiting for it would stall the CPU on the GPU
+
+	if (host_reset)
+		frame.query_pool->reset(0, frame.scopes.size() * 2);
+	frame.scopes.clear();
+}
+
+uint32_t GPUProfiler::begin(const char* name)
+{
+	if (!supported)
+		return NONE;
+
+	// Without host query reset the scope's queries are reset in the command buffer, which can't be done inside a render pass
+	CommandBuffer& command_buffer = RenderContext::getCommandBuffer();
+	if (!host_reset && command_buffer.getActive().render_pass)
+		return NONE;
+
+	std::scoped_lock lock(mutex);
+	Frame& frame = frames[RenderContext::getFrame()];
+	if (frame.scopes.size() >= MAX_SCOPES)
+		return NONE;
+	if (frame.scopes.empty())
+		frame.recorded = Profiler::getTime();
+	uint32_t scope = frame.scopes.size();
+	frame.scopes.emplace_back(name);
+	if (!host_reset)
+		command_buffer.resetQueryPool(*frame.query_pool, scope * 2, 2);
+	frame.query_pool->writeTimestamp(PipelineStage::TOP, scope * 2);
+	return scope;
+}
+
+void GPUProfiler::end(uint32_t scope)
+{
+	if (scope == NONE)
+		return;
+
+	std::scoped_lock lock(mutex);
+	frames[RenderContext::getFrame()].query_pool->writeTimestamp(PipelineStage::BOTTOM, scope * 2 + 1);
+}
\ No newline at end of file
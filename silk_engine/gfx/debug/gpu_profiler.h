@@ -0,0 +1,58 @@
+#pragma once
+
+#include "silk_engine/gfx/render_context.h"
+
+class QueryPool;
+
+// Times GPU scopes with timestamp queries, feeds the GPU frame time to FrameStatistics and, while a Profiler capture runs,
+// adds the scopes to its timeline on a "GPU" track. Every frame in flight has its own queries, they are read back without waiting when that frame comes around again.
+// Without the hostQueryReset feature, scopes opened inside a render pass are skipped, as their queries can't be reset there.
+// GPU and CPU clocks aren't calibrated against each other: a frame's GPU scopes are placed from when its first scope
+// was recorded, or from where the previous frame's GPU scopes ended if that is later
+class GPUProfiler
+{
+public:
+	static constexpr uint32_t MAX_SCOPES = 256; // Per frame
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	class Scope : NoCopyNoMove
+	{
+	public:
+		Scope(const char* name)
+			: scope(GPUProfiler::begin(name)) {}
+		~Scope() { GPUProfiler::end(scope); }
+
+	private:
+		uint32_t scope = NONE;
+	};
+
+public:
+	static void init();
+	static void destroy();
+	// Resolves and resets the current frame's queries, call once the commands of its previous use finished
+	static void update();
+
+	// Writes a timestamp into the calling thread's command buffer
+	// @param name must outlive the capture, e.g. a string literal
+	// @return NONE when timestamps aren't supported or the frame is out of scopes
+	static uint32_t begin(const char* name);
+	static void end(uint32_t scope);
+
+private:
+	struct Frame
+	{
+		shared<QueryPool> query_pool = nullptr;
+		std::vector<const char*> scopes;
+		uint64_t recorded = 0; // Profiler time when the first scope was recorded
+	};
+
+private:
+	static inline std::array<Frame, RenderContext::MAX_FRAMES> frames = {};
+	static inline uint32_t track = 0;
+	static inline double timestamp_period = 0.0; // Nanoseconds per tick
+	static inline uint32_t timestamp_bits = 64; // Valid low bits of a timestamp, the rest is garbage
+	static inline bool host_reset = false; // Queries are reset from the host after reading, otherwise in the command buffer before use
+	static inline uint64_t last_end = 0;
+	static inline bool supported = false;
+	static inline std::mutex mutex;
+};
\ No newline at end of file
@@ -19,10 +19,11 @@ DescriptorSet::DescriptorSet(const DescriptorSetLayout& layout)
 
 DescriptorSet::~DescriptorSet()
 {
-	pool->deallocate();
+	// Frames in flight may still have it bound
+	RenderContext::destroyDeferred([pool = pool] { pool->deallocate(); });
 }
 
-void DescriptorSet::write(uint32_t binding, const std::vector<VkDescriptorBufferInfo>& buffer_infos, uint32_t array_index)
+void DescriptorSet::write(uint32_t binding, std::span<const VkDescriptorBufferInfo> buffer_infos, uint32_t array_index)
 {
 	for (size_t i = 0; i < buffer_infos.size(); ++i)
 	{
@@ -37,7 +38,7 @@ void DescriptorSet::write(uint32_t binding, const std::vector<VkDescriptorBuffer
 	}
 }
 
-void DescriptorSet::write(uint32_t binding, const std::vector<VkDescriptorImageInfo>& image_infos, uint32_t array_index)
+void DescriptorSet::write(uint32_t binding, std::span<const VkDescriptorImageInfo> image_infos, uint32_t array_index)
 {
 	for (size_t i = 0; i < image_infos.size(); ++i)
 	{
@@ -52,9 +53,9 @@ void DescriptorSet::write(uint32_t binding, const std::vector<VkDescriptorImageI
 	}
 }
 
-void DescriptorSet::write(uint32_t binding, const std::vector<VkBufferView>& buffer_views, uint32_t array_index)
+void DescriptorSet::write(uint32_t binding, std::span<const VkBufferView> buffer_views, uint32_t array_index)
 {
-	for (size_t i = 0; i < image_infos.size(); ++i)
+	for (size_t i = 0; i < buffer_views.size(); ++i)
 	{
 		VkBufferView& existing_buffer_view = this->buffer_views.at(binding)[array_index + i];
 		if (existing_buffer_view != buffer_views[i])
@@ -67,17 +68,17 @@ void DescriptorSet::write(uint32_t binding, const std::vector<VkBufferView>& buf
 
 void DescriptorSet::write(uint32_t binding, const VkDescriptorBufferInfo& buffer_info, uint32_t array_index)
 {
-	write(binding, std::vector<VkDescriptorBufferInfo> { buffer_info }, array_index);
+	write(binding, std::span<const VkDescriptorBufferInfo>(&buffer_info, 1), array_index);
 }
 
 void DescriptorSet::write(uint32_t binding, const VkDescriptorImageInfo& image_info, uint32_t array_index)
 {
-	write(binding, std::vector<VkDescriptorImageInfo> { image_info }, array_index);
+	write(binding, std::span<const VkDescriptorImageInfo>(&image_info, 1), array_index);
 }
 
 void DescriptorSet::write(uint32_t binding, const VkBufferView& buffer_view, uint32_t array_index)
 {
-	write(binding, std::vector<VkBufferView> { buffer_view }, array_index);
+	write(binding, std::span<const VkBufferView>(&buffer_view, 1), array_index);
 }
 
 void DescriptorSet::update()
@@ -9,9 +9,9 @@ public:
 	DescriptorSet(const DescriptorSetLayout& layout);
 	~DescriptorSet();
 
-	void write(uint32_t binding, const std::vector<VkDescriptorBufferInfo>& buffer_infos, uint32_t array_index = 0);
-	void write(uint32_t binding, const std::vector<VkDescriptorImageInfo>& image_infos, uint32_t array_index = 0);
-	void write(uint32_t binding, const std::vector<VkBufferView>& buffer_views, uint32_t array_index = 0);
+	void write(uint32_t binding, std::span<const VkDescriptorBufferInfo> buffer_infos, uint32_t array_index = 0);
+	void write(uint32_t binding, std::span<const VkDescriptorImageInfo> image_infos, uint32_t array_index = 0);
+	void write(uint32_t binding, std::span<const VkBufferView> buffer_views, uint32_t array_index = 0);
 	void write(uint32_t binding, const VkDescriptorBufferInfo& buffer_info, uint32_t array_index = 0);
 	void write(uint32_t binding, const VkDescriptorImageInfo& image_info, uint32_t array_index = 0);
 	void write(uint32_t binding, const VkBufferView& buffer_view, uint32_t array_index = 0); 
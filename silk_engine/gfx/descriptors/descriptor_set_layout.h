@@ -1,7 +1,6 @@
 #pragma once
 
-struct Hash;
-struct Equal;
+#include "silk_engine/utils/hash_map.h"
 
 class DescriptorSetLayout : NoCopy
 {
@@ -32,18 +31,22 @@ public:
 	static void destroy() { descriptor_set_layouts.clear(); }
 
 private:
-	struct Hash
+	struct BindingsHash
 	{
 		size_t operator()(const std::vector<VkDescriptorSetLayoutBinding>& bindings) const
 		{
-			size_t result = bindings.size();
+			// Only the compared fields, immutable sampler pointers and padding aren't part of the key
+			uint64_t result = bindings.size();
 			for (const VkDescriptorSetLayoutBinding& b : bindings)
-				result ^= b.binding ^ (b.descriptorType << 8) ^ (b.descriptorCount << 16) ^ (b.stageFlags << 24);
+			{
+				result = Hash::combine(result, uint64_t(b.binding) << 32 | b.descriptorType);
+				result = Hash::combine(result, uint64_t(b.descriptorCount) << 32 | b.stageFlags);
+			}
 			return result;
 		}
 	};
 
-	struct Equal
+	struct BindingsEqual
 	{
 		bool operator()(const std::vector<VkDescriptorSetLayoutBinding>& bindings, const std::vector<VkDescriptorSetLayoutBinding>& other) const
 		{
@@ -63,5 +66,5 @@ private:
 		}
 	};
 
-	static inline std::unordered_map<std::vector<VkDescriptorSetLayoutBinding>, shared<DescriptorSetLayout>, Hash, Equal> descriptor_set_layouts{};
+	static inline HashMap<std::vector<VkDescriptorSetLayoutBinding>, shared<DescriptorSetLayout>, BindingsHash, BindingsEqual> descriptor_set_layouts{};
 };
\ No newline at end of file
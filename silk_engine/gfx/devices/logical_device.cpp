@@ -102,7 +102,7 @@ LogicalDevice::LogicalDevice(const PhysicalDevice& physical_device, const std::v
 LogicalDevice::~LogicalDevice()
 {
 	wait();
-	vkDestroyDevice(logical_device, nullptr);
+	vkDestroyDevice(logical_device, RenderContext::getAllocationCallbacks());
 }
 
 bool LogicalDevice::hasExtension(const char* extension) const
@@ -318,6 +318,25 @@ void LogicalDevice::destroyDescriptorSetLayout(VkDescriptorSetLayout descriptor_
 	vkDestroyDescriptorSetLayout(logical_device, descriptor_set_layout, nullptr);
 }
 
+VkImage LogicalDevice::createImage(const VkImageCreateInfo& image_info) const
+{
+	VkImage image = nullptr;
+	RenderContext::vulkanAssert(vkCreateImage(logical_device, &image_info, nullptr, &image));
+	return image;
+}
+
+void LogicalDevice::destroyImage(VkImage image) const
+{
+	vkDestroyImage(logical_device, image, nullptr);
+}
+
+VkMemoryRequirements LogicalDevice::getImageMemoryRequirements(VkImage image) const
+{
+	VkMemoryRequirements memory_requirements{};
+	vkGetImageMemoryRequirements(logical_device, image, &memory_requirements);
+	return memory_requirements;
+}
+
 VkSubresourceLayout LogicalDevice::getImageSubresourceLayout(VkImage image, const VkImageSubresource& image_subresource) const
 {
 	VkSubresourceLayout subresource_layout{};
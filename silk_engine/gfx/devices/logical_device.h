@@ -49,6 +49,9 @@ public:
 	void updateDescriptorSets(const std::vector<VkWriteDescriptorSet>& writes) const;
 	VkDescriptorSetLayout createDescriptorSetLayout(const VkDescriptorSetLayoutCreateInfo& descriptor_set_layout_create_info) const;
 	void destroyDescriptorSetLayout(VkDescriptorSetLayout descriptor_set_layout) const;
+	VkImage createImage(const VkImageCreateInfo& image_info) const;
+	void destroyImage(VkImage image) const;
+	VkMemoryRequirements getImageMemoryRequirements(VkImage image) const;
 	VkSubresourceLayout getImageSubresourceLayout(VkImage image, const VkImageSubresource& image_subresource) const;
 	VkImageView createImageView(const VkImageViewCreateInfo& image_view_info) const;
 	void destroyImageView(VkImageView image_view) const;
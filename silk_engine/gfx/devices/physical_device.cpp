@@ -117,6 +117,14 @@ bool PhysicalDevice::supportsExtension(const char* extension_name) const
 	return supported_extensions.contains(extension_name); 
 }
 
+bool PhysicalDevice::supportsLazilyAllocatedMemory() const
+{
+	for (uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i)
+		if (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)
+			return true;
+	return false;
+}
+
 bool PhysicalDevice::supportsFeature(PhysicalDevice::Feature feature) const
 {
 	constexpr size_t off = (sizeof(VkStructureType) + sizeof(void*)) / sizeof(VkBool32);
@@ -134,7 +142,7 @@ bool PhysicalDevice::supportsFeature(PhysicalDevice::Feature feature) const
 VkDevice PhysicalDevice::createLogicalDevice(const VkDeviceCreateInfo& create_info) const
 {
 	VkDevice device = nullptr;
-	RenderContext::vulkanAssert(vkCreateDevice(physical_device, &create_info, nullptr, &device));
+	RenderContext::vulkanAssert(vkCreateDevice(physical_device, &create_info, RenderContext::getAllocationCallbacks(), &device));
 	return device;
 }
 
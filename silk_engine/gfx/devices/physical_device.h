@@ -152,6 +152,8 @@ public:
 
 	bool supportsExtension(const char* extension_name) const;
 	bool supportsFeature(Feature feature) const;
+	// Lazily allocated memory is only backed when a tiler spills an attachment out of tile memory
+	bool supportsLazilyAllocatedMemory() const;
 	uint32_t alignSize(uint32_t original_size) const
 	{
 		size_t min_ubo_alignment = properties.limits.minUniformBufferOffsetAlignment;
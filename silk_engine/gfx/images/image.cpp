@@ -104,10 +104,68 @@ Image::Image(std::span<const std::array<fs::path, 6>> files, const Props& props)
 
 Image::~Image()
 {
-	view = nullptr;
-	sampler = nullptr;
-	if (VmaAllocation(allocation) != nullptr)
-		RenderContext::getAllocator().destroyImage(image, allocation);
+	// Frames in flight may still sample it, the view and the shared allocation go with it
+	RenderContext::destroyDeferred([image = image, allocation = VmaAllocation(allocation), view = std::move(view), sampler = std::move(sampler), aliased_allocation = std::move(aliased_allocation)]() mutable
+		{
+			view = nullptr;
+			sampler = nullptr;
+			if (aliased_allocation)
+				RenderContext::getLogicalDevice().destroyImage(image);
+			else if (allocation != nullptr)
+				RenderContext::getAllocator().destroyImage(image, allocation);
+			aliased_allocation = nullptr;
+		});
+}
+
+std::vector<shared<Image>> Image::createAliased(std::span<const Props> props)
+{
+	std::vector<shared<Image>> images(props.size());
+	std::vector<VkMemoryRequirements> requirements(props.size());
+	for (size_t i = 0; i < props.size(); ++i)
+	{
+		images[i] = shared<Image>(new Image());
+		images[i]->props = props[i];
+		images[i]->create(false);
+		requirements[i] = RenderContext::getLogicalDevice().getImageMemoryRequirements(*images[i]);
+	}
+
+	// Images whose memory types have nothing in common can't share, so they're split into groups that can
+	std::vector<bool> bound(props.size(), false);
+	for (size_t first = 0; first < props.size(); ++first)
+	{
+		if (bound[first])
+			continue;
+		VkMemoryRequirements group_requirements = requirements[first];
+		std::vector<size_t> group;
+		for (size_t i = first; i < props.size(); ++i)
+		{
+			if (bound[i] || !(group_requirements.memoryTypeBits & requirements[i].memoryTypeBits))
+				continue;
+			group_requirements.size = std::max(group_requirements.size, requirements[i].size);
+			group_requirements.alignment = std::max(group_requirements.alignment, requirements[i].alignment);
+			group_requirements.memoryTypeBits &= requirements[i].memoryTypeBits;
+			group.emplace_back(i);
+			bound[i] = true;
+		}
+
+		VmaAllocationCreateInfo alloc_ci{};
+		alloc_ci.usage = (VmaMemoryUsage)props[first].allocation_props.preferred_device;
+		alloc_ci.flags = props[first].allocation_props.flags;
+		alloc_ci.priority = props[first].allocation_props.priority;
+		shared<Allocation> allocation(new Allocation(RenderContext::getAllocator().allocateMemory(group_requirements, alloc_ci)), [](Allocation* allocation)
+		{
+			RenderContext::getAllocator().freeMemory(*allocation);
+			delete allocation;
+		});
+		for (size_t i : group)
+		{
+			RenderContext::getAllocator().bindImageMemory(*allocation, *images[i]);
+			images[i]->allocation = *allocation;
+			images[i]->aliased_allocation = allocation;
+			images[i]->createView();
+		}
+	}
+	return images;
 }
 
 VkDescriptorImageInfo Image::getDescriptorInfo() const
@@ -291,7 +349,7 @@ bool Image::isFeatureSupported(VkFormatFeatureFlags feature) const
 	return (features & feature) == feature;
 }
 
-void Image::create()
+void Image::create(bool allocate)
 {
 	layouts.resize(1, VK_IMAGE_LAYOUT_UNDEFINED);
 	if (image == nullptr)
@@ -316,16 +374,28 @@ void Image::create()
 		layouts.resize(mip_levels * props.layers, VK_IMAGE_LAYOUT_UNDEFINED);
 		setLayout(props.initial_layout);
 
-		VmaAllocationCreateInfo alloc_ci{};
-		alloc_ci.usage = (VmaMemoryUsage)props.allocation_props.preferred_device;
-		alloc_ci.flags = props.allocation_props.flags;
-		alloc_ci.priority = props.allocation_props.priority;
-		allocation = RenderContext::getAllocator().allocateImage(ci, alloc_ci, image);
+		if (allocate)
+		{
+			VmaAllocationCreateInfo alloc_ci{};
+			alloc_ci.usage = (VmaMemoryUsage)props.allocation_props.preferred_device;
+			alloc_ci.flags = props.allocation_props.flags;
+			alloc_ci.priority = props.allocation_props.priority;
+			allocation = RenderContext::getAllocator().allocateImage(ci, alloc_ci, image);
+		}
+		else
+			image = RenderContext::getLogicalDevice().createImage(ci);
 
 		if (bool(props.usage & ImageUsage::SAMPLED))
 			sampler = Sampler::get(props.sampler_props);
 	}
 
+	// Views need bound memory, unallocated images create theirs once they're bound
+	if (allocate)
+		createView();
+}
+
+void Image::createView()
+{
 	// Determining if image should create ImageView based on usage (Note: this is probably correct, but not sure)
 	if (bool(props.usage & (ImageUsage::SAMPLED | ImageUsage::STORAGE | ImageUsage::COLOR_ATTACHMENT | ImageUsage::DEPTH_STENCIL_ATTACHMENT | ImageUsage::INPUT_ATTACHMENT | ImageUsage::TRANSIENT_ATTACHMENT)))
 		view = makeShared<ImageView>(*this);
@@ -480,7 +550,8 @@ void Image::insertMemoryBarrier(const VkImage& image, VkImageLayout old_layout,
 
 shared<Image> Image::add(std::string_view name, const shared<Image>& image)
 {
-	images.insert_or_assign(name, image);
-	RenderContext::getLogicalDevice().setObjectName(VK_OBJECT_TYPE_IMAGE, VkImage(*image), name.data());
+	StringId id = StringId::intern(name);
+	images.insert_or_assign(id, image);
+	RenderContext::getLogicalDevice().setObjectName(VK_OBJECT_TYPE_IMAGE, VkImage(*image), id.getString().data());
 	return image;
 }
\ No newline at end of file
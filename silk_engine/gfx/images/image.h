@@ -2,6 +2,7 @@
 
 #include "silk_engine/gfx/allocators/allocation.h"
 #include "sampler.h"
+#include "silk_engine/utils/string_id.h"
 
 class ImageView;
 template <typename T>
@@ -42,6 +43,9 @@ public:
 	Image(uint32_t width, uint32_t height, Format format, VkImage img); // Constructor used for swap chain image creation ONLY
 	~Image();
 
+	// Images bound to shared memory, only valid when their contents are never needed at the same time
+	static std::vector<shared<Image>> createAliased(std::span<const Props> props);
+
 	uint32_t getWidth() const { return props.width; }
 	uint32_t getHeight() const { return props.height; }
 	uint32_t getDepth() const { return props.depth; }
@@ -84,9 +88,12 @@ public:
 	bool isFeatureSupported(VkFormatFeatureFlags feature) const;
 	
 private:
+	Image() = default;
+
 	VkImageLayout& getLayout(uint32_t base_mip_level = 0, uint32_t base_layer = 0) { return layouts[base_layer * mip_levels + base_mip_level]; }
 
-	void create();
+	void create(bool allocate = true);
+	void createView();
 	void generateMipmaps();
 
 private:
@@ -103,11 +110,12 @@ private:
 	shared<ImageView> view = nullptr;
 	std::vector<VkImageLayout> layouts = {}; // layout / mip / layer
 	Allocation allocation{};
+	shared<Allocation> aliased_allocation = nullptr; // Owns allocation when it's shared with other images
 	Props props = {};
 	uint32_t mip_levels = 1;
 
 public:
-	static shared<Image> get(std::string_view name) 
+	static shared<Image> get(StringId name) 
 	{ 
 		if (auto it = images.find(name); it != images.end()) 
 			return it->second; 
@@ -117,5 +125,5 @@ public:
 	static void destroy() { images.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<Image>> images{};
+	static inline HashMap<StringId, shared<Image>> images{};
 };
\ No newline at end of file
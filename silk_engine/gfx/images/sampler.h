@@ -1,5 +1,7 @@
 #pragma once
 
+#include "silk_engine/utils/hash_map.h"
+
 class Sampler
 {
 public:
@@ -37,16 +39,17 @@ public:
 	static void destroy() { samplers.clear(); }
 
 private:
-	struct Hash
+	struct PropsHash
 	{
 		size_t operator()(const Props& props) const
 		{
-			size_t result = size_t(props.min_filter) ^ (size_t(props.mag_filter) << 1) ^ (size_t(props.u_wrap) << 4) ^ (size_t(props.v_wrap) << 7) ^ (size_t(props.v_wrap) << 10) ^ (size_t(props.mipmap_mode) << 12);
-			return result ^ *(const uint32_t*)&props.anisotropy;
+			uint64_t result = Hash::combine(uint64_t(props.min_filter) << 32 | uint64_t(props.mag_filter), uint64_t(props.u_wrap) << 32 | uint64_t(props.v_wrap));
+			result = Hash::combine(result, uint64_t(props.w_wrap) << 32 | uint64_t(props.mipmap_mode));
+			return Hash::combine(result, std::bit_cast<uint32_t>(props.anisotropy));
 		}
 	};
 
-	struct Equal
+	struct PropsEqual
 	{
 		bool operator()(const Props& props, const Props& other) const
 		{
@@ -55,5 +58,5 @@ private:
 		}
 	};
 
-	static inline std::unordered_map<Props, shared<Sampler>, Hash, Equal> samplers{};
+	static inline HashMap<Props, shared<Sampler>, PropsHash, PropsEqual> samplers{};
 };
\ No newline at end of file
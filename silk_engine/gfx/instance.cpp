@@ -63,7 +63,7 @@ Instance::Instance(std::string_view app_name)
     features.pNext = &debug_messenger->getCreateInfo();
 #endif
    
-    RenderContext::vulkanAssert(vkCreateInstance(&ci, nullptr, &instance));
+    RenderContext::vulkanAssert(vkCreateInstance(&ci, RenderContext::getAllocationCallbacks(), &instance));
 
     uint32_t physical_device_count = 0;
     vkEnumeratePhysicalDevices(instance, &physical_device_count, nullptr);
@@ -80,7 +80,7 @@ Instance::~Instance()
 #ifdef SK_ENABLE_DEBUG_MESSENGER
     delete debug_messenger;
 #endif
-    vkDestroyInstance(instance, nullptr);
+    vkDestroyInstance(instance, RenderContext::getAllocationCallbacks());
 }
 
 bool Instance::checkVulkanVersionSupport(VulkanVersion minimum_version) const
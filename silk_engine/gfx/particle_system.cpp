@@ -11,13 +11,11 @@
 #include "pipeline/graphics_pipeline.h"
 #include "pipeline/material.h"
 
-unique<ThreadPool> ParticleSystem::thread_pool = nullptr;
-
 void ParticleSystem::init(VkRenderPass render_pass)
 {
-	instance_vbo = makeShared<Buffer>(sizeof(ParticleData) * MAX_PARTICLES, BufferUsage::VERTEX, Allocation::Props{ Allocation::SEQUENTIAL_WRITE | Allocation::MAPPED, Allocation::Device::CPU });
+    for (auto& instance_vbo : instance_vbos)
+        instance_vbo = makeShared<Buffer>(sizeof(ParticleData) * MAX_PARTICLES, BufferUsage::VERTEX, Allocation::Props{ Allocation::SEQUENTIAL_WRITE | Allocation::MAPPED, Allocation::Device::CPU });
     instance_images = makeShared<InstanceImages>();
-    thread_pool = makeUnique<ThreadPool>();
 
     shared<GraphicsPipeline> pipeline = makeShared<GraphicsPipeline>();
     pipeline->setShader(makeShared<Shader>("particle"))
@@ -103,7 +101,7 @@ void ParticleSystem::update()
     auto camera = Scene::getActive()->getMainCamera();
     if (camera)
     {
-        thread_pool->forEach(particles.size(), [&](size_t i)
+        ThreadPool::get().parallelFor(particles.size(), [&](size_t i)
             {
                 auto& p = particles[i];
                 float life = 1.0f - p.life_remaining / p.life_time;
@@ -123,9 +121,8 @@ void ParticleSystem::update()
                 particle_data[i].color = math::lerp(p.color_begin, p.color_end, life);
                 particle_data[i].iamge_index = p.iamge_index;
             });
-        thread_pool->wait();
     }
-    instance_vbo->setData(particle_data.data(), particle_data.size() * sizeof(ParticleData));
+    instance_vbos[RenderContext::getFrame()]->setData(particle_data.data(), particle_data.size() * sizeof(ParticleData));
 }
 
 void ParticleSystem::render(Material& material)
@@ -135,14 +132,14 @@ void ParticleSystem::render(Material& material)
         material.set("GlobalUniform", *DebugRenderer::getGlobalUniformBuffer());
         material.set("images", instance_images->getDescriptorImageInfos());
         material.bind();
-        Mesh::get("Quad")->bind();
-        instance_vbo->bindVertex(1);
-        RenderContext::getCommandBuffer().drawIndexed(Mesh::get("Quad")->getIndexCount(), particle_data.size(), 0, 0, 0);
+        Mesh::get("Quad"_id)->bind();
+        instance_vbos[RenderContext::getFrame()]->bindVertex(1);
+        RenderContext::getCommandBuffer().drawIndexed(Mesh::get("Quad"_id)->getIndexCount(), particle_data.size(), 0, 0, 0);
     }
 }
 
 void ParticleSystem::destroy()
 {
-    instance_vbo = nullptr;
+    instance_vbos = {};
     instance_images = nullptr;
 }
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 
+#include "render_context.h"
+
 class Image;
 class InstanceImages;
-class ThreadPool;
 class Material;
 class Buffer;
 
@@ -85,8 +86,7 @@ private:
 	static inline std::vector<Particle> particles;
 	static inline std::vector<ParticleSpout> particle_spouts;
 	static inline std::vector<ParticleData> particle_data;
-	static inline shared<Buffer> instance_vbo;
+	static inline std::array<shared<Buffer>, RenderContext::MAX_FRAMES> instance_vbos; // Per frame in flight
 	static inline shared<InstanceImages> instance_images;
-	static unique<ThreadPool> thread_pool;
 	static inline shared<Material> material = nullptr;
 };
\ No newline at end of file
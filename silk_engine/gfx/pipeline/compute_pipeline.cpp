@@ -3,6 +3,7 @@
 #include "silk_engine/gfx/render_context.h"
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/buffers/command_buffer.h"
+#include "silk_engine/gfx/debug/gpu_profiler.h"
 
 ComputePipeline::ComputePipeline(const shared<Shader>& shader, const std::vector<Constant>& constants)
 {
@@ -22,6 +23,7 @@ void ComputePipeline::dispatch(uint32_t global_invocation_count_x, uint32_t glob
 	uvec3 global_invocation_count(global_invocation_count_x, global_invocation_count_y, global_invocation_count_z);
 	uvec3 local_size = shader->getReflectionData().local_size;
 	uvec3 group_count = (global_invocation_count + local_size - uvec3(1)) / local_size;
+	GPUProfiler::Scope gpu_scope("ComputePipeline::dispatch");
 	RenderContext::getCommandBuffer().dispatch(group_count.x, group_count.y, group_count.z);
 }
 
@@ -16,10 +16,10 @@ private:
 	VkComputePipelineCreateInfo ci{};
 
 public:
-	static shared<ComputePipeline> get(std::string_view name) { if (auto it = compute_pipelines.find(name); it != compute_pipelines.end()) return it->second; else return nullptr; }
-	static shared<ComputePipeline> add(std::string_view name, const shared<ComputePipeline> compute_pipeline) { return compute_pipelines.insert_or_assign(name, compute_pipeline).first->second; }
+	static shared<ComputePipeline> get(StringId name) { if (auto it = compute_pipelines.find(name); it != compute_pipelines.end()) return it->second; else return nullptr; }
+	static shared<ComputePipeline> add(std::string_view name, const shared<ComputePipeline> compute_pipeline) { return compute_pipelines.insert_or_assign(StringId::intern(name), compute_pipeline).first->second; }
 	static void destroy() { compute_pipelines.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<ComputePipeline>> compute_pipelines{};
+	static inline HashMap<StringId, shared<ComputePipeline>> compute_pipelines{};
 };
\ No newline at end of file
@@ -154,10 +154,10 @@ private:
 	uint32_t subpass = 0;
 
 public:
-	static shared<GraphicsPipeline> get(std::string_view name) { if (auto it = graphics_pipelines.find(name); it != graphics_pipelines.end()) return it->second; else return nullptr; }
-	static shared<GraphicsPipeline> add(std::string_view name, const shared<GraphicsPipeline> graphics_pipeline) { return graphics_pipelines.insert_or_assign(name, graphics_pipeline).first->second; }
+	static shared<GraphicsPipeline> get(StringId name) { if (auto it = graphics_pipelines.find(name); it != graphics_pipelines.end()) return it->second; else return nullptr; }
+	static shared<GraphicsPipeline> add(std::string_view name, const shared<GraphicsPipeline> graphics_pipeline) { return graphics_pipelines.insert_or_assign(StringId::intern(name), graphics_pipeline).first->second; }
 	static void destroy() { graphics_pipelines.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<GraphicsPipeline>> graphics_pipelines{};
+	static inline HashMap<StringId, shared<GraphicsPipeline>> graphics_pipelines{};
 };
\ No newline at end of file
@@ -27,13 +27,15 @@ void Material::set(std::string_view name, const std::vector<shared<Buffer>>& buf
 void Material::set(std::string_view name, const VkDescriptorBufferInfo& buffer)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, buffer);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, buffer);
 }
 
 void Material::set(std::string_view name, const std::vector<VkDescriptorBufferInfo>& buffers)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, buffers);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, buffers);
 }
 
 void Material::set(std::string_view name, const Image& image)
@@ -52,32 +54,42 @@ void Material::set(std::string_view name, const std::vector<shared<Image>>& imag
 void Material::set(std::string_view name, const VkDescriptorImageInfo& image)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, image);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, image);
 }
 
 void Material::set(std::string_view name, const std::vector<VkDescriptorImageInfo>& images)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, images);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, images);
 }
 
 void Material::set(std::string_view name, VkBufferView buffer_view)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, buffer_view);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, buffer_view);
 }
 
 void Material::set(std::string_view name, const std::vector<VkBufferView>& buffer_views)
 {
 	if (const Shader::ResourceLocation& location = pipeline->getShader()->getLocation(name))
-		getDescriptorSet(location.set)->write(location.binding, buffer_views);
+		for (const auto& descriptor_set : getDescriptorSets(location.set))
+			descriptor_set->write(location.binding, buffer_views);
+}
+
+void Material::update()
+{
+	for (auto&& [set, frame_descriptor_sets] : descriptor_sets)
+		frame_descriptor_sets[RenderContext::getFrame()]->update();
 }
 
 void Material::bind()
 {
 	pipeline->bind();
-	for (auto&& [set, descriptor_set] : descriptor_sets)
-		descriptor_set->bind(set);
+	for (auto&& [set, frame_descriptor_sets] : descriptor_sets)
+		frame_descriptor_sets[RenderContext::getFrame()]->bind(set);
 }
 
 void Material::dispatch(uint32_t global_invocation_count_x, uint32_t global_invocation_count_y, uint32_t global_invocation_count_z)
@@ -85,9 +97,12 @@ void Material::dispatch(uint32_t global_invocation_count_x, uint32_t global_invo
 	std::dynamic_pointer_cast<ComputePipeline>(pipeline)->dispatch(global_invocation_count_x, global_invocation_count_y, global_invocation_count_z);
 }
 
-const shared<DescriptorSet>& Material::getDescriptorSet(uint32_t set)
+Material::DescriptorSets& Material::getDescriptorSets(uint32_t set)
 {
 	if (auto it = descriptor_sets.find(set); it != descriptor_sets.end())
 		return it->second;
-	return descriptor_sets.emplace(set, makeShared<DescriptorSet>(*pipeline->getShader()->getReflectionData().descriptor_set_layouts.at(set))).first->second;
+	DescriptorSets& frame_descriptor_sets = descriptor_sets[set];
+	for (auto& descriptor_set : frame_descriptor_sets)
+		descriptor_set = makeShared<DescriptorSet>(*pipeline->getShader()->getReflectionData().descriptor_set_layouts.at(set));
+	return frame_descriptor_sets;
 }
\ No newline at end of file
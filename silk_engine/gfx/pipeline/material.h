@@ -1,5 +1,7 @@
 #pragma once
 
+#include "silk_engine/gfx/render_context.h"
+
 class Pipeline;
 class ComputePipeline;
 class GraphicsPipeline;
@@ -9,6 +11,10 @@ class Buffer;
 
 class Material : NoCopy
 {
+public:
+	// One set per frame in flight, set() queues writes to all of them and each is only updated while its frame is current
+	using DescriptorSets = std::array<shared<DescriptorSet>, RenderContext::MAX_FRAMES>;
+
 public:
 	Material(const shared<Pipeline>& pipeline)
 		: pipeline(pipeline) {}
@@ -31,16 +37,18 @@ public:
 
 	void set(std::string_view name, const std::vector<VkBufferView>& buffer_views);
 
+	// Writes pending descriptor updates of the current frame's sets, after which bind only records commands and can run on several threads at once
+	void update();
 	void bind();
 	void dispatch(uint32_t global_invocation_count_x, uint32_t global_invocation_count_y = 1, uint32_t global_invocation_count_z = 1);
 
 	const shared<Pipeline>& getPipeline() const { return pipeline; }
-	const std::unordered_map<uint32_t, shared<DescriptorSet>>& getDescriptorSets() const { return descriptor_sets; }
+	const std::unordered_map<uint32_t, DescriptorSets>& getDescriptorSets() const { return descriptor_sets; }
 
 private:
-	const shared<DescriptorSet>& getDescriptorSet(uint32_t set);
+	DescriptorSets& getDescriptorSets(uint32_t set);
 
 private:
 	shared<Pipeline> pipeline = nullptr;
-	std::unordered_map<uint32_t, shared<DescriptorSet>> descriptor_sets = {};
+	std::unordered_map<uint32_t, DescriptorSets> descriptor_sets = {};
 };
\ No newline at end of file
@@ -3,16 +3,39 @@
 
 Resource& Pass::addAttachment(const char* name, Format format, VkSampleCountFlagBits samples, const std::vector<Resource*>& inputs)
 {
-	Resource& resource = render_graph.addResource(makeUnique<Resource>(name, Resource::Type::ATTACHMENT, *this));
+	SK_VERIFY(type == Type::RENDER, "Pass: Compute pass \"{}\" can't write attachment \"{}\"", this->name, name);
+	Resource& resource = addOutput(name, Resource::Type::ATTACHMENT, inputs);
 	resource.attachment.format = format;
 	resource.attachment.samples = samples;
-	outputs.emplace_back(&resource);
-	for (Resource* input : inputs)
-		this->inputs.emplace_back(input);
+	return resource;
+}
+
+Resource& Pass::addBuffer(const char* name, const shared<Buffer>& buffer, const std::vector<Resource*>& inputs)
+{
+	SK_VERIFY(type == Type::COMPUTE, "Pass: Render pass \"{}\" can't write buffer \"{}\", only attachments", this->name, name);
+	Resource& resource = addOutput(name, Resource::Type::BUFFER, inputs);
+	resource.setBuffer(buffer);
+	return resource;
+}
+
+Resource& Pass::addImage(const char* name, const shared<Image>& image, const std::vector<Resource*>& inputs)
+{
+	SK_VERIFY(type == Type::COMPUTE, "Pass: Render pass \"{}\" can't write image \"{}\", only attachments", this->name, name);
+	Resource& resource = addOutput(name, Resource::Type::IMAGE, inputs);
+	resource.setImage(image);
 	return resource;
 }
 
 const RenderPass& Pass::getRenderPass() const
 {
 	return render_graph.getRenderPass();
+}
+
+Resource& Pass::addOutput(const char* name, Resource::Type type, const std::vector<Resource*>& inputs)
+{
+	Resource& resource = render_graph.addResource(makeUnique<Resource>(name, type, *this));
+	outputs.emplace_back(&resource);
+	for (Resource* input : inputs)
+		this->inputs.emplace_back(input);
+	return resource;
 }
\ No newline at end of file
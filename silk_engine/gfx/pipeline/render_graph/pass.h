@@ -1,10 +1,10 @@
 #pragma once
 
-#include "silk_engine/gfx/images/image.h"
+#include "resource.h"
 
-class Resource;
 class RenderGraph;
 class RenderPass;
+class Buffer;
 
 class Pass
 {
@@ -16,24 +16,38 @@ public:
 	};
 
 public:
-	Pass(const char* name, Type type, RenderGraph& render_graph)
-		: name(name), type(type), render_graph(render_graph) {}
+	Pass(const char* name, Type type, RenderGraph& render_graph, uint32_t index)
+		: name(name), type(type), render_graph(render_graph), index(index) {}
 	
+	// Render passes write attachments, compute passes write storage buffers and images
 	Resource& addAttachment(const char* name, Format format = Format::BGRA, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT, const std::vector<Resource*>& inputs = {});
+	Resource& addBuffer(const char* name, const shared<Buffer>& buffer, const std::vector<Resource*>& inputs = {});
+	Resource& addImage(const char* name, const shared<Image>& image, const std::vector<Resource*>& inputs = {});
 	void setRenderCallback(std::function<void(const RenderGraph& render_graph)>&& render_callback) { this->render_callback = std::move(render_callback); }
 	void setSubpass(uint32_t subpass) { render.subpass = subpass; }
+	// Render callback records through RenderGraph::record, on worker threads into secondary command buffers
+	void setParallel(bool parallel = true) { render.parallel = parallel; }
 
 	const std::vector<Resource*>& getInputs() const { return inputs; }
 	const std::vector<Resource*>& getOutputs() const { return outputs; }
 	const RenderPass& getRenderPass() const;
 	uint32_t getSubpass() const { return render.subpass; }
+	bool isParallel() const { return render.parallel; }
+	const char* getName() const { return name; }
+	Type getType() const { return type; }
+	// Order the pass was added in, indexes the render graph's passes
+	uint32_t getIndex() const { return index; }
 
 	void callRender() const { render_callback(render_graph); }
+
+private:
+	Resource& addOutput(const char* name, Resource::Type type, const std::vector<Resource*>& inputs);
 	
 private:
 	const char* name;
 	Type type;
 	RenderGraph& render_graph;
+	uint32_t index = 0;
 	std::vector<Resource*> inputs;
 	std::vector<Resource*> outputs;
 
@@ -43,5 +57,6 @@ private:
 	struct Render
 	{
 		uint32_t subpass = 0;
+		bool parallel = false;
 	} render;
 };
\ No newline at end of file
@@ -7,6 +7,46 @@
 #include "silk_engine/gfx/sync/semaphore.h"
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/allocators/query_pool.h"
+#include "silk_engine/gfx/debug/gpu_profiler.h"
+#include "silk_engine/gfx/devices/physical_device.h"
+#include "silk_engine/gfx/buffers/buffer.h"
+#include "silk_engine/utils/frame_statistics.h"
+
+namespace
+{
+	// Render passes can read compute results anywhere from indirect draws to fragment shaders
+	constexpr PipelineStage GRAPHICS_READ_STAGES = PipelineStage::DRAW_INDIRECT | PipelineStage::VERTEX_INPUT | PipelineStage::VERTEX | PipelineStage::FRAGMENT;
+	constexpr VkAccessFlags GRAPHICS_READ_ACCESS = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+	VkImageMemoryBarrier makeImageBarrier(const Image& image, VkImageLayout old_layout, VkImageLayout new_layout, VkAccessFlags source_access, VkAccessFlags destination_access, uint32_t source_family = VK_QUEUE_FAMILY_IGNORED, uint32_t destination_family = VK_QUEUE_FAMILY_IGNORED)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = source_access;
+		barrier.dstAccessMask = destination_access;
+		barrier.oldLayout = old_layout;
+		barrier.newLayout = new_layout;
+		barrier.srcQueueFamilyIndex = source_family;
+		barrier.dstQueueFamilyIndex = destination_family;
+		barrier.image = image;
+		barrier.subresourceRange = { ecast(image.getAspect()), 0, image.getMipLevels(), 0, image.getLayers() };
+		return barrier;
+	}
+
+	VkBufferMemoryBarrier makeBufferBarrier(const Buffer& buffer, VkAccessFlags source_access, VkAccessFlags destination_access, uint32_t source_family = VK_QUEUE_FAMILY_IGNORED, uint32_t destination_family = VK_QUEUE_FAMILY_IGNORED)
+	{
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = source_access;
+		barrier.dstAccessMask = destination_access;
+		barrier.srcQueueFamilyIndex = source_family;
+		barrier.dstQueueFamilyIndex = destination_family;
+		barrier.buffer = buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+		return barrier;
+	}
+}
 
 RenderGraph::~RenderGraph()
 {
@@ -15,71 +55,59 @@ RenderGraph::~RenderGraph()
 
 void RenderGraph::build(const char* backbuffer)
 {
-	render_finished = makeShared<Semaphore>();
-	swap_chain_image_available = makeShared<Semaphore>();
 
-	// Deduce which ones are root passes -> passes that have all the outputs unused are root passes
-	std::vector<Pass*> roots;
-	for (auto& pass : passes)
+	const Resource* backbuffer_resource = nullptr;
+	if (backbuffer)
 	{
-		for (auto& pass2 : passes)
-		{
-			bool should_remove = false;
-			if (pass != pass2)
-			{
-				for (const auto& input : pass->getInputs())
-				{
-					if (&input->getPass() == pass2.get())
-					{
-						should_remove = true;
-						break;
-					}
-				}
-			}
-			if (!should_remove)
-				roots.emplace_back(pass2.get());
-		}
+		if (auto it = resources_map.find(backbuffer); it != resources_map.end())
+			backbuffer_resource = it->second;
+		else
+			SK_ERROR("RenderGraph: Backbuffer \"{}\" isn't an output of any pass", backbuffer);
 	}
+	compile(backbuffer_resource);
 
-	// Sort passes based on execution order
-	sorted_passes.reserve(passes.size());
-	auto build_node = [&](this auto&& self, Pass& pass) -> void
+	compute_passes.clear();
+	render_passes.clear();
+	for (Pass* pass : sorted_passes)
+		(pass->getType() == Pass::Type::COMPUTE ? compute_passes : render_passes).emplace_back(pass);
+	compute_results.clear();
+	for (Pass* pass : render_passes)
+		for (const Resource* input : pass->getInputs())
+			if (input->getType() != Resource::Type::ATTACHMENT && std::ranges::find(compute_results, input) == compute_results.end())
+				compute_results.emplace_back(input);
+	const PhysicalDevice& physical_device = RenderContext::getPhysicalDevice();
+	async_compute = !compute_passes.empty() && physical_device.getComputeQueue() != physical_device.getGraphicsQueue();
+	for (Frame& frame : frames)
 	{
-		sorted_passes.emplace_back(&pass);
-		for (const auto& input : pass.getInputs())
-			self(input->getPass());
-	};
-	for (Pass* root : roots)
-		build_node(*root);
-	
-	// Remove duplicate passes
-	for (int i = 1; i < sorted_passes.size(); ++i)
-	{
-		auto it = std::find(sorted_passes.begin(), sorted_passes.begin() + i, sorted_passes[i]);
-		if (it != sorted_passes.begin() + i)
-		{
-			sorted_passes.erase(it);
-			--i;
-		}
+		frame.image_available = makeShared<Semaphore>();
+		frame.compute_finished = (async_compute && !compute_results.empty()) ? makeShared<Semaphore>() : nullptr;
+		frame.query_pool = makeShared<QueryPool>(QueryPool::VERTEX_SHADER_INVOCATIONS | QueryPool::GEOMETRY_SHADER_PRIMITIVES | QueryPool::FRAGMENT_SHADER_INVOCATIONS | QueryPool::COMPUTE_SHADER_INVOCATIONS);
+		frame.statistics_pending = false;
 	}
-
-	std::ranges::reverse(sorted_passes);
+	graphics_finished = frames.front().compute_finished ? makeShared<Semaphore>() : nullptr;
+	graphics_finished_pending = false;
+	if (async_compute)
+		for (const Resource* result : compute_results)
+			SK_VERIFY(result->getBuffer() || result->getImage(), "RenderGraph: \"{}\" needs a buffer or image, its ownership moves from the compute queue to graphics", result->getName());
 
 	render_pass = makeShared<RenderPass>();
-	for (Pass* pass : sorted_passes)
+	for (Pass* pass : render_passes)
 	{
 		pass->setSubpass(render_pass->addSubpass());
+		// Producers come first in sorted order, so their attachment indices and subpasses are already set
+		for (Resource* input : pass->getInputs())
+		{
+			if (input->getType() != Resource::Type::ATTACHMENT)
+				continue; // Compute results are made visible before the render pass begins
+			render_pass->addInputAttachment(input->attachment.index);
+			render_pass->addSubpassDependency(input->getPass().getSubpass(), pass->getSubpass(), 
+				isColorFormat(input->attachment.format) ? PipelineStage::COLOR_ATTACHMENT_OUTPUT : PipelineStage::EARLY_FRAGMENT_TESTS, PipelineStage::FRAGMENT, 
+				isColorFormat(input->attachment.format) ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, 
+				VK_ACCESS_INPUT_ATTACHMENT_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
+		}
 		for (Resource* output : pass->getOutputs())
 		{
-			for (Resource* input : pass->getInputs())
-			{
-				render_pass->addInputAttachment(input->attachment.index);
-				render_pass->addSubpassDependency(input->getPass().getSubpass(), output->getPass().getSubpass(), 
-					isColorFormat(input->attachment.format) ? PipelineStage::COLOR_ATTACHMENT_OUTPUT : PipelineStage::EARLY_FRAGMENT_TESTS, PipelineStage::FRAGMENT, 
-					isColorFormat(input->attachment.format) ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, 
-					VK_ACCESS_INPUT_ATTACHMENT_READ_BIT, VK_DEPENDENCY_BY_REGION_BIT);
-			}
-			
+			bool backbuffer_output = output == backbuffer_resource;
 			AttachmentProps props{};
 			props.format = output->attachment.format;
 			if (isDepthOnlyFormat(props.format))
@@ -88,21 +116,30 @@ void RenderGraph::build(const char* backbuffer)
 				props.final_layout = VK_IMAGE_LAYOUT_STENCIL_ATTACHMENT_OPTIMAL;
 			else if (isDepthStencilFormat(props.format))
 				props.final_layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-			else if (backbuffer && strcmp(output->getName(), backbuffer) == 0) // If color attachment is root, then it is present src
+			else if (backbuffer_output) // If color attachment is root, then it is present src
 				props.final_layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 			else
 				props.final_layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 			props.samples = output->attachment.samples;
-			props.load_operation = output->attachment.clear.has_value() ? VK_ATTACHMENT_LOAD_OP_CLEAR : VK_ATTACHMENT_LOAD_OP_DONT_CARE; // TODO: LOAD_OP_LOAD for RMW
-			props.store_operation = VK_ATTACHMENT_STORE_OP_STORE; // TODO: In case of depth attachments this is unnecessary, unless it's read from subsequent passes
+			// Only what's read after the render pass is stored, everything else is transient and may never leave tile memory.
+			// Exported attachments without a clear keep their contents from the previous frame
+			if (output->attachment.clear.has_value())
+				props.load_operation = VK_ATTACHMENT_LOAD_OP_CLEAR;
+			else if (output->isExported() && !backbuffer_output)
+			{
+				props.load_operation = VK_ATTACHMENT_LOAD_OP_LOAD;
+				props.initial_layout = props.final_layout;
+			}
+			else
+				props.load_operation = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			props.store_operation = (output->isExported() || backbuffer_output) ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
 			output->attachment.index = render_pass->addAttachment(props);
-
 		}
 	}
 	render_pass->build();
 
 	// Set render pass attachment clear values
-	for (Pass* pass : sorted_passes)
+	for (Pass* pass : render_passes)
 	{
 		for (Resource* output : pass->getOutputs())
 		{
@@ -117,74 +154,360 @@ void RenderGraph::build(const char* backbuffer)
 	}
 
 	resize(Window::get().getSwapChain());
-
-	query_pool = makeShared<QueryPool>(QueryPool::VERTEX_SHADER_INVOCATIONS | QueryPool::GEOMETRY_SHADER_PRIMITIVES | QueryPool::FRAGMENT_SHADER_INVOCATIONS | QueryPool::COMPUTE_SHADER_INVOCATIONS);
 }
 
 void RenderGraph::render(Statistics* statistics)
 {
-	if (command_buffer)
-		command_buffer->wait();
+	SK_PROFILE_FUNCTION();
+	// RenderContext::update already waited for this frame's previous use, so its semaphores and queries are free again
+	Frame& frame = frames[RenderContext::getFrame()];
+	{
+		SK_FRAME_STATISTICS_SCOPE("Wait");
+		if (!Window::get().getSwapChain().acquireNextImage(*frame.image_available))
+		{
+			Window::get().recreate();
+			resize(Window::get().getSwapChain());
+		}
+	}
+	SK_FRAME_STATISTICS_SCOPE("Render"); // Recording, submit and present
 
-	if (!Window::get().getSwapChain().acquireNextImage(*swap_chain_image_available))
+	if (statistics && frame.statistics_pending)
 	{
-		Window::get().recreate();
-		resize(Window::get().getSwapChain());
+		std::vector<uint32_t> results = frame.query_pool->getResults(0, true);
+		memcpy(statistics, results.data(), results.size() * sizeof(uint32_t));
+	}
+	frame.statistics_pending = statistics;
+
+	std::vector<PipelineStage> wait_stages = { PipelineStage::TOP };
+	std::vector<VkSemaphore> wait_semaphores = { *frame.image_available };
+	if (async_compute)
+	{
+		// Submitted first so it overlaps with graphics, which only waits where it reads compute results
+		recordCompute();
+		std::vector<VkSemaphore> signal_semaphores;
+		if (frame.compute_finished)
+		{
+			signal_semaphores.emplace_back(*frame.compute_finished);
+			wait_stages.emplace_back(GRAPHICS_READ_STAGES);
+			wait_semaphores.emplace_back(*frame.compute_finished);
+		}
+		// The previous frame's graphics may still be reading the results this overwrites
+		std::vector<PipelineStage> compute_wait_stages;
+		std::vector<VkSemaphore> compute_wait_semaphores;
+		if (graphics_finished_pending)
+		{
+			compute_wait_stages.emplace_back(PipelineStage::COMPUTE);
+			compute_wait_semaphores.emplace_back(*graphics_finished);
+		}
+		RenderContext::submitCompute(compute_wait_stages, compute_wait_semaphores, signal_semaphores);
 	}
 
+	uint32_t gpu_scope = GPUProfiler::begin("RenderGraph::render");
 	if (statistics)
-		query_pool->begin();
-	render_pass->begin();
+		frame.query_pool->begin();
+	if (async_compute)
+		insertComputeResultBarriers(true);
+	else if (!compute_passes.empty())
+		recordCompute();
 
 	uint32_t width = render_pass->getWidth();
 	uint32_t height = render_pass->getHeight();
 
-	VkViewport viewport = {};
+	viewport = {};
 	viewport.x = 0.0f;
 	viewport.y = float(height);
 	viewport.width = float(width);
 	viewport.height = -float(height);
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
-	RenderContext::getCommandBuffer().setViewport({ viewport });
 
-	VkRect2D scissor = {};
+	scissor = {};
 	scissor.offset = { 0, 0 };
 	scissor.extent = { width, height };
-	RenderContext::getCommandBuffer().setScissor({ scissor });
 
-	for (const auto& pass : sorted_passes)
+	// Secondaries can only execute inside the statistics query when they inherit it
+	bool secondaries_allowed = !statistics || RenderContext::getLogicalDevice().hasFeature(PhysicalDevice::Feature::INHERITED_QUERIES);
+	for (size_t i = 0; i < render_passes.size(); ++i)
 	{
-		pass->callRender();
-		for (Resource* output : pass->getOutputs())
+		const Pass& pass = *render_passes[i];
+		recording_secondary = pass.isParallel() && secondaries_allowed;
+		VkSubpassContents contents = recording_secondary ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+		if (i == 0)
+			render_pass->begin(contents);
+		else
+			render_pass->nextSubpass(contents);
+
+		if (recording_secondary)
+		{
+			// The primary can only execute secondaries in this subpass, so there is no GPU profiler scope around it
+			const auto& active = RenderContext::getCommandBuffer().getActive();
+			inheritance_info = {};
+			inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+			inheritance_info.renderPass = active.render_pass;
+			inheritance_info.subpass = active.subpass;
+			inheritance_info.framebuffer = active.framebuffer;
+			inheritance_info.pipelineStatistics = statistics ? frame.query_pool->getPipelineStatistics() : 0;
+			pass.callRender();
+			executeSecondaries();
+			recording_secondary = false;
+		}
+		else
+		{
+			// Executing secondaries in an earlier subpass leaves the primary's dynamic state undefined
+			RenderContext::getCommandBuffer().setViewport(viewport);
+			RenderContext::getCommandBuffer().setScissor(scissor);
+			GPUProfiler::Scope pass_scope(pass.getName());
+			pass.callRender();
+		}
+		for (Resource* output : pass.getOutputs())
 			output->getAttachment()->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-		render_pass->nextSubpass();
 	}
 	render_pass->end();
 	if (statistics)
-		query_pool->end();
+		frame.query_pool->end();
+	GPUProfiler::end(gpu_scope);
 
-	command_buffer = RenderContext::submit({ PipelineStage::TOP }, { *swap_chain_image_available }, { *render_finished });
+	const Semaphore& render_finished = *this->render_finished[Window::get().getSwapChain().getImageIndex()];
+	std::vector<VkSemaphore> signal_semaphores = { render_finished };
+	if (graphics_finished)
+		signal_semaphores.emplace_back(*graphics_finished);
+	graphics_finished_pending = graphics_finished != nullptr;
+	RenderContext::submit(wait_stages, wait_semaphores, signal_semaphores);
 
-	if (statistics)
+	if (!Window::get().getSwapChain().present(render_finished))
 	{
-		std::vector<uint32_t> results = query_pool->getResults(0, true);
-		memcpy(statistics, results.data(), results.size() * sizeof(uint32_t));
+		Window::get().recreate();
+		resize(Window::get().getSwapChain());
 	}
+}
 
-	if (!Window::get().getSwapChain().present(*render_finished))
+Pass& RenderGraph::addPass(const char* name, Pass::Type type)
+{
+	passes.emplace_back(makeUnique<Pass>(name, type, *this, uint32_t(passes.size())));
+	bool added = passes_map.emplace(name, passes.back().get()).second;
+	SK_VERIFY(added, "RenderGraph: Pass name \"{}\" is already used", name);
+	return *passes.back();
+}
+
+void RenderGraph::compile(const Resource* backbuffer)
+{
+	size_t pass_count = passes.size();
+	std::vector<std::vector<uint32_t>> consumers(pass_count);
+	for (const auto& pass : passes)
 	{
-		Window::get().recreate();
-		resize(Window::get().getSwapChain());
+		for (const Resource* input : pass->getInputs())
+		{
+			const Pass& producer = input->getPass();
+			if (producer.getIndex() >= pass_count || passes[producer.getIndex()].get() != &producer)
+			{
+				SK_ERROR("RenderGraph: Pass \"{}\" reads \"{}\", which belongs to another render graph", pass->getName(), input->getName());
+				continue;
+			}
+			if (pass->getType() == Pass::Type::COMPUTE && input->getType() == Resource::Type::ATTACHMENT)
+			{
+				SK_ERROR("RenderGraph: Compute pass \"{}\" reads attachment \"{}\", compute passes run before the render pass", pass->getName(), input->getName());
+				continue;
+			}
+			consumers[producer.getIndex()].emplace_back(pass->getIndex());
+		}
+	}
+
+	// Walk back from the sinks through inputs, passes that aren't reached don't contribute to anything used
+	std::vector<bool> alive(pass_count, false);
+	std::vector<uint32_t> stack;
+	auto keep = [&](const Resource& resource)
+	{
+		uint32_t index = resource.getPass().getIndex();
+		if (index < pass_count && passes[index].get() == &resource.getPass() && !alive[index])
+		{
+			alive[index] = true;
+			stack.emplace_back(index);
+		}
+	};
+	if (backbuffer)
+		keep(*backbuffer);
+	for (const auto& resource : resources)
+		if (resource->isExported())
+			keep(*resource);
+	if (stack.empty())
+		alive.assign(pass_count, true); // Nothing marks what's used, so nothing can be culled
+	while (!stack.empty())
+	{
+		const Pass& pass = *passes[stack.back()];
+		stack.pop_back();
+		for (const Resource* input : pass.getInputs())
+			keep(*input);
+	}
+
+	// Kahn's algorithm, ready passes are taken in the order they were added so the result is stable
+	std::vector<uint32_t> in_degree(pass_count, 0);
+	for (uint32_t producer = 0; producer < pass_count; ++producer)
+		if (alive[producer])
+			for (uint32_t consumer : consumers[producer])
+				in_degree[consumer] += alive[consumer];
+	std::vector<uint32_t> ready;
+	for (uint32_t index = 0; index < pass_count; ++index)
+		if (alive[index] && !in_degree[index])
+			ready.emplace_back(index);
+
+	sorted_passes.clear();
+	for (size_t next = 0; next < ready.size(); ++next)
+	{
+		sorted_passes.emplace_back(passes[ready[next]].get());
+		for (uint32_t consumer : consumers[ready[next]])
+			if (alive[consumer] && !--in_degree[consumer])
+				ready.emplace_back(consumer);
+	}
+
+	size_t alive_count = std::ranges::count(alive, true);
+	if (sorted_passes.size() < alive_count)
+	{
+		std::string cycle;
+		for (uint32_t index = 0; index < pass_count; ++index)
+			if (alive[index] && in_degree[index])
+				cycle += std::format("{}\"{}\"", cycle.empty() ? "" : ", ", passes[index]->getName());
+		SK_ERROR("RenderGraph: Passes {} are in or depend on a cycle, they are left out", cycle);
+	}
+	if (alive_count < pass_count)
+		for (uint32_t index = 0; index < pass_count; ++index)
+			if (!alive[index])
+				SK_TRACE("RenderGraph: Culled pass \"{}\", nothing uses its outputs", passes[index]->getName());
+}
+
+void RenderGraph::recordCompute()
+{
+	std::optional<RenderContext::ComputeScope> compute_scope;
+	if (async_compute)
+		compute_scope.emplace();
+
+	for (Pass* pass : compute_passes)
+	{
+		// Earlier compute writes are made visible to this pass, and images it writes are moved to GENERAL, discarding last frame's contents.
+		// On the graphics queue the outputs also have to wait for the previous frame's draws that read them, on the
+		// compute queue the graphics_finished semaphore already does
+		std::vector<VkMemoryBarrier> memory_barriers;
+		if (!pass->getInputs().empty())
+			memory_barriers.emplace_back(VkMemoryBarrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = VK_ACCESS_SHADER_READ_BIT });
+		std::vector<VkBufferMemoryBarrier> buffer_barriers;
+		std::vector<VkImageMemoryBarrier> image_barriers;
+		for (Resource* output : pass->getOutputs())
+		{
+			if (output->getBuffer())
+				buffer_barriers.emplace_back(makeBufferBarrier(*output->getBuffer(), VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+			if (!output->getImage())
+				continue;
+			image_barriers.emplace_back(makeImageBarrier(*output->getImage(), VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT));
+			output->getImage()->setLayout(VK_IMAGE_LAYOUT_GENERAL);
+		}
+		PipelineStage source_stages = async_compute ? PipelineStage::COMPUTE : GRAPHICS_READ_STAGES | PipelineStage::COMPUTE;
+		if (!memory_barriers.empty() || !buffer_barriers.empty() || !image_barriers.empty())
+			RenderContext::getCommandBuffer().pipelineBarrier(source_stages, PipelineStage::COMPUTE, VkDependencyFlags(0), memory_barriers, buffer_barriers, image_barriers);
+
+		GPUProfiler::Scope pass_scope(pass->getName());
+		pass->callRender();
+	}
+	insertComputeResultBarriers(false);
+}
+
+void RenderGraph::insertComputeResultBarriers(bool acquire)
+{
+	if (compute_results.empty())
+		return;
+
+	std::vector<VkMemoryBarrier> memory_barriers;
+	std::vector<VkBufferMemoryBarrier> buffer_barriers;
+	std::vector<VkImageMemoryBarrier> image_barriers;
+	if (!async_compute)
+	{
+		// Same queue, one barrier from compute writes to graphics reads
+		memory_barriers.emplace_back(VkMemoryBarrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER, .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT, .dstAccessMask = GRAPHICS_READ_ACCESS });
+		for (const Resource* result : compute_results)
+		{
+			if (!result->getImage())
+				continue;
+			image_barriers.emplace_back(makeImageBarrier(*result->getImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, GRAPHICS_READ_ACCESS));
+			result->getImage()->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
+		RenderContext::getCommandBuffer().pipelineBarrier(PipelineStage::COMPUTE, GRAPHICS_READ_STAGES, VkDependencyFlags(0), memory_barriers, buffer_barriers, image_barriers);
+		return;
+	}
+
+	// RULE: Queue family ownership transfers are a release on the compute queue and an identical acquire on graphics,
+	// the release has no destination access and the acquire no source access, the semaphore orders them
+	uint32_t compute_family = RenderContext::getPhysicalDevice().getComputeQueue();
+	uint32_t graphics_family = RenderContext::getPhysicalDevice().getGraphicsQueue();
+	VkAccessFlags source_access = acquire ? VK_ACCESS_NONE : VK_ACCESS_SHADER_WRITE_BIT;
+	VkAccessFlags destination_access = acquire ? GRAPHICS_READ_ACCESS : VK_ACCESS_NONE;
+	for (const Resource* result : compute_results)
+	{
+		if (result->getBuffer())
+			buffer_barriers.emplace_back(makeBufferBarrier(*result->getBuffer(), source_access, destination_access, compute_family, graphics_family));
+		if (result->getImage())
+		{
+			image_barriers.emplace_back(makeImageBarrier(*result->getImage(), VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, source_access, destination_access, compute_family, graphics_family));
+			result->getImage()->setLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+		}
 	}
+	RenderContext::getCommandBuffer().pipelineBarrier(acquire ? GRAPHICS_READ_STAGES : PipelineStage::COMPUTE, acquire ? GRAPHICS_READ_STAGES : PipelineStage::BOTTOM, VkDependencyFlags(0), memory_barriers, buffer_barriers, image_barriers);
 }
 
 void RenderGraph::resize(const SwapChain& swap_chain)
 {
 	render_pass->resize(swap_chain);
+	while (render_finished.size() < swap_chain.getImages().size())
+		render_finished.emplace_back(makeShared<Semaphore>());
 }
 
 const shared<Image>& RenderGraph::getAttachment(std::string_view resource_name) const
 {
 	return resources_map.at(resource_name)->getAttachment();
 }
+
+void RenderGraph::record(size_t count, std::function<void(size_t begin, size_t end)>&& function, size_t grain) const
+{
+	if (!count)
+		return;
+	if (!recording_secondary)
+	{
+		function(0, count);
+		return;
+	}
+
+	// Recorded on the shared job system, its workers keep their command pools between frames
+	ThreadPool& pool = ThreadPool::get();
+	grain = grain ? grain : (count + pool.size() - 1) / pool.size();
+	auto shared_function = makeShared<std::function<void(size_t, size_t)>>(std::move(function));
+	for (size_t begin = 0; begin < count; begin += grain)
+	{
+		VkCommandBuffer* secondary = &secondary_command_buffers.emplace_back(nullptr);
+		size_t end = std::min(begin + grain, count);
+		pool.schedule([this, secondary, shared_function, begin, end]
+			{
+				CommandBuffer& command_buffer = RenderContext::getSecondaryCommandBuffer();
+				command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, inheritance_info);
+				// Dynamic state isn't inherited from the primary
+				command_buffer.setViewport(viewport);
+				command_buffer.setScissor(scissor);
+				{
+					RenderContext::RecordScope record_scope(command_buffer);
+					(*shared_function)(begin, end);
+				}
+				command_buffer.end();
+				*secondary = command_buffer;
+			}, {}, &recording);
+	}
+}
+
+void RenderGraph::record(std::function<void()>&& function) const
+{
+	record(1, [function = std::move(function)](size_t, size_t) { function(); }, 1);
+}
+
+void RenderGraph::executeSecondaries()
+{
+	ThreadPool::get().wait(recording);
+	if (secondary_command_buffers.empty())
+		return;
+	RenderContext::getCommandBuffer().executeCommands(std::vector<VkCommandBuffer>(secondary_command_buffers.begin(), secondary_command_buffers.end()));
+	secondary_command_buffers.clear();
+}
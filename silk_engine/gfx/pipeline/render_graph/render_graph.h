@@ -2,11 +2,13 @@
 
 #include "resource.h"
 #include "pass.h"
+#include "silk_engine/gfx/render_context.h"
+#include "silk_engine/utils/thread_pool.h"
+#include <deque>
 
 class RenderPass;
 class SwapChain;
 class Semaphore;
-class CommandBuffer;
 class QueryPool;
 
 class RenderGraph
@@ -23,18 +25,8 @@ public:
 public:
 	~RenderGraph();
 
-	Pass& addPass(const char* name) 
-	{
-		passes.emplace_back(makeUnique<Pass>(name, Pass::Type::RENDER, *this));
-		passes_map.emplace(name, passes.back().get());
-		return *passes.back(); 
-	}
-	Pass& addComputePass(const char* name)
-	{
-		passes.emplace_back(makeUnique<Pass>(name, Pass::Type::COMPUTE, *this));
-		passes_map.emplace(name, passes.back().get());
-		return *passes.back();
-	}
+	Pass& addPass(const char* name) { return addPass(name, Pass::Type::RENDER); }
+	Pass& addComputePass(const char* name) { return addPass(name, Pass::Type::COMPUTE); }
 	Resource& addResource(unique<Resource>&& resource) 
 	{ 
 		resources_map.emplace(resource->getName(), resource.get());
@@ -42,23 +34,64 @@ public:
 		return *resources.back();
 	}
 
+	// Culls passes that neither the backbuffer nor an exported resource depends on, then orders the rest.
+	// Attachments that aren't exported or the backbuffer are transient, and non-overlapping ones may share memory.
+	// Compute passes run before the render pass, on the dedicated compute queue when the device has one
 	void build(const char* backbuffer = nullptr);
+	// Records and submits without waiting for earlier frames, up to RenderContext::MAX_FRAMES are in flight
+	// @param statistics gets the pipeline statistics of the frame MAX_FRAMES earlier, once there is one
 	void render(Statistics* statistics = nullptr);
 	void resize(const SwapChain& swap_chain);
+	// From the render callback of a parallel pass: records function(begin, end) for ranges of [0, count) on worker threads,
+	// every range into its own secondary command buffer, which getCommandBuffer returns there. The subpass executes them
+	// in the order they were recorded, so a later call draws over an earlier one. Other passes record inline
+	// @param grain indices per secondary command buffer, 0 gives every worker one range
+	void record(size_t count, std::function<void(size_t begin, size_t end)>&& function, size_t grain = 0) const;
+	void record(std::function<void()>&& function) const;
 
 	const shared<Image>& getAttachment(std::string_view resource_name) const;
 	const Pass& getPass(std::string_view name) const { return *passes_map.at(name); }
 	const RenderPass& getRenderPass() const { return *render_pass; }
 
+private:
+	Pass& addPass(const char* name, Pass::Type type);
+	void compile(const Resource* backbuffer);
+	void recordCompute();
+	// Barriers that make compute results visible to render passes. With async compute they're a queue family ownership transfer,
+	// released at the end of compute and acquired before the render pass
+	void insertComputeResultBarriers(bool acquire);
+	// Waits for the secondaries record() started and executes them in order
+	void executeSecondaries();
+
 private:
 	std::vector<unique<Pass>> passes;
 	std::unordered_map<std::string_view, const Pass*> passes_map;
 	std::vector<Pass*> sorted_passes;
+	std::vector<Pass*> compute_passes;
+	std::vector<Pass*> render_passes; // Subpasses of render_pass
+	std::vector<const Resource*> compute_results; // Compute outputs that render passes read
+	bool async_compute = false;
 	shared<RenderPass> render_pass = nullptr;
-	shared<QueryPool> query_pool = nullptr;
 	std::vector<unique<Resource>> resources;
 	std::unordered_map<std::string_view, const Resource*> resources_map;
-	shared<CommandBuffer> command_buffer = nullptr;
-	shared<Semaphore> render_finished = nullptr;
-	shared<Semaphore> swap_chain_image_available = nullptr;
+	std::vector<shared<Semaphore>> render_finished; // Per swap chain image, presenting it may outlast the frame's fence
+
+	struct Frame
+	{
+		shared<Semaphore> image_available = nullptr;
+		shared<Semaphore> compute_finished = nullptr;
+		shared<QueryPool> query_pool = nullptr;
+		bool statistics_pending = false; // query_pool holds the statistics of the frame's previous use
+	};
+	std::array<Frame, RenderContext::MAX_FRAMES> frames;
+	shared<Semaphore> graphics_finished = nullptr; // Async compute of the next frame waits on it before overwriting results
+	bool graphics_finished_pending = false;
+
+	// Secondary recording of the current subpass, mutable since render callbacks only get a const graph
+	mutable ThreadPool::JobCounter recording;
+	mutable std::deque<VkCommandBuffer> secondary_command_buffers; // Stable addresses, workers fill them in while more are added
+	VkCommandBufferInheritanceInfo inheritance_info{};
+	VkViewport viewport{};
+	VkRect2D scissor{};
+	bool recording_secondary = false;
 };
\ No newline at end of file
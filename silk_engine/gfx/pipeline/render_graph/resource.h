@@ -3,6 +3,7 @@
 #include "silk_engine/gfx/images/image.h"
 
 class Pass;
+class Buffer;
 
 class Resource
 {
@@ -10,6 +11,7 @@ public:
 	enum class Type
 	{
 		BUFFER,
+		IMAGE,
 		ATTACHMENT
 	};
 
@@ -22,14 +24,24 @@ public:
 	Pass& getPass() { return pass; }
 	const Pass& getPass() const { return pass; }
 	const shared<Image>& getAttachment() const;
+	const shared<Buffer>& getBuffer() const { return storage.buffer; }
+	const shared<Image>& getImage() const { return storage.image; }
+
+	// Storage can be replaced, e.g. on resize, barriers use what's set when the graph renders
+	void setBuffer(const shared<Buffer>& buffer) { storage.buffer = buffer; }
+	void setImage(const shared<Image>& image) { storage.image = image; }
 
 	void setClearColor(const VkClearColorValue& clear_color) { attachment.clear = VkClearValue{ .color = clear_color }; }
 	void setClearDepthStencil(const VkClearDepthStencilValue& clear_depth_stencil) { attachment.clear = VkClearValue{ .depthStencil = clear_depth_stencil }; }
+	// Exported resources are read outside of the graph, so their pass is never culled and their contents are stored
+	void setExported(bool exported = true) { this->exported = exported; }
+	bool isExported() const { return exported; }
 
 private:
 	const char* name;
 	Type type;
 	Pass& pass;
+	bool exported = false;
 
 public:
 	struct AttachmentInfo
@@ -39,4 +51,11 @@ public:
 		std::optional<VkClearValue> clear = std::nullopt;
 		size_t index = 0;
 	} attachment = {};
+
+	// Written by compute passes, and assumed to be rewritten every frame, so previous contents are discarded
+	struct StorageInfo
+	{
+		shared<Buffer> buffer = nullptr;
+		shared<Image> image = nullptr; // In VK_IMAGE_LAYOUT_GENERAL during compute, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL after
+	} storage = {};
 };
\ No newline at end of file
@@ -1,11 +1,11 @@
 #include "render_pass.h"
 #include "silk_engine/gfx/render_context.h"
 #include "silk_engine/gfx/devices/logical_device.h"
+#include "silk_engine/gfx/devices/physical_device.h"
 #include "silk_engine/gfx/buffers/framebuffer.h"
 #include "silk_engine/gfx/window/swap_chain.h"
 
 // TODO:
-// figure stuff out with VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT
 // Support subpass input depth attachments
 
 size_t RenderPass::addSubpass()
@@ -22,10 +22,10 @@ void RenderPass::addInputAttachment(uint32_t index)
     subpass_info.input_attachment_references.emplace_back();
     auto& input_attachment = subpass_info.input_attachment_references.back();
     input_attachment.attachment = index;
+    attachment_lifetimes[index].last = subpass_infos.size() - 1;
 
-    // RULE: Subpasses that are used in a subsequent subpass as an input attachment always have STORE_OP_STORE
-    auto& previous_output_attachment = attachment_descriptions[index];
-    previous_output_attachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    // NOTE: Store ops only apply at the end of the render pass, so being read by a later subpass doesn't need STORE_OP_STORE
+    const auto& previous_output_attachment = attachment_descriptions[index];
     switch (previous_output_attachment.finalLayout)
     {
     case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
@@ -142,6 +142,8 @@ size_t RenderPass::addAttachment(const AttachmentProps& attachment_props)
         clear_values.emplace_back(clear_value);
     }
     attachment_descriptions.emplace_back(std::move(attachment_description)); 
+    uint32_t subpass = subpass_infos.size() - 1;
+    attachment_lifetimes.resize(attachment_descriptions.size(), Lifetime{ subpass, subpass });
     if (isColorFormat(attachment_props.format) && multisampled)
         return attachment_descriptions.size() - 2;
     return attachment_descriptions.size() - 1;
@@ -173,6 +175,10 @@ void RenderPass::build()
         subpass_description.pPreserveAttachments = subpass_info.preserve_attachment_references.data();
     }
 
+    // Lazily allocated memory is never backed while attachments stay in tile memory, so there's nothing to save by aliasing it
+    if (!RenderContext::getPhysicalDevice().supportsLazilyAllocatedMemory())
+        aliasTransientAttachments();
+
     VkRenderPassCreateInfo ci{};
     ci.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
     ci.attachmentCount = attachment_descriptions.size();
@@ -187,6 +193,52 @@ void RenderPass::build()
         clear_values.clear();
 }
 
+bool RenderPass::isTransient(uint32_t attachment) const
+{
+    const auto& attachment_description = attachment_descriptions[attachment];
+    return attachment_description.loadOp != VK_ATTACHMENT_LOAD_OP_LOAD && attachment_description.stencilLoadOp != VK_ATTACHMENT_LOAD_OP_LOAD
+        && attachment_description.storeOp == VK_ATTACHMENT_STORE_OP_DONT_CARE && attachment_description.stencilStoreOp == VK_ATTACHMENT_STORE_OP_DONT_CARE
+        && attachment_description.finalLayout != VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+void RenderPass::aliasTransientAttachments()
+{
+    std::vector<uint32_t> transients;
+    for (uint32_t attachment = 0; attachment < attachment_descriptions.size(); ++attachment)
+        if (isTransient(attachment))
+            transients.emplace_back(attachment);
+    std::ranges::stable_sort(transients, {}, [&](uint32_t attachment) { return attachment_lifetimes[attachment].first; });
+
+    // Interval partitioning, an attachment joins the first group whose last member is done before it starts
+    std::vector<std::vector<uint32_t>> groups;
+    for (uint32_t attachment : transients)
+    {
+        auto group = std::ranges::find_if(groups, [&](const auto& group) { return attachment_lifetimes[group.back()].last < attachment_lifetimes[attachment].first; });
+        if (group != groups.end())
+            group->emplace_back(attachment);
+        else
+            groups.emplace_back(1, attachment);
+    }
+
+    aliased_attachments.clear();
+    for (auto& group : groups)
+    {
+        if (group.size() < 2)
+            continue;
+        // RULE: Attachments that share memory have VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT, and each one's last use is ordered before the next one's first use
+        for (size_t i = 0; i < group.size(); ++i)
+        {
+            attachment_descriptions[group[i]].flags |= VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT;
+            if (i)
+                addSubpassDependency(attachment_lifetimes[group[i - 1]].last, attachment_lifetimes[group[i]].first,
+                    PipelineStage::COLOR_ATTACHMENT_OUTPUT | PipelineStage::LATE_FRAGMENT_TESTS | PipelineStage::FRAGMENT, PipelineStage::EARLY_FRAGMENT_TESTS | PipelineStage::COLOR_ATTACHMENT_OUTPUT,
+                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_DEPENDENCY_BY_REGION_BIT);
+        }
+        aliased_attachments.emplace_back(std::move(group));
+    }
+}
+
 RenderPass::~RenderPass()
 {
     RenderContext::getLogicalDevice().destroyRenderPass(render_pass);
@@ -30,6 +30,13 @@ class RenderPass : NoCopy
 		std::vector<VkAttachmentReference> input_attachment_references;
 	};
 
+	// First and last subpass that reference an attachment
+	struct Lifetime
+	{
+		uint32_t first = 0;
+		uint32_t last = 0;
+	};
+
 public:
 	~RenderPass();
 
@@ -59,6 +66,10 @@ public:
 	void resize(const SwapChain& swap_chain);
 
 	bool isInputAttachment(uint32_t attachment) const { return attachments_used_as_inputs.contains(attachment); }
+	// Contents neither come from before nor are needed after the render pass, so they can stay in tile memory
+	bool isTransient(uint32_t attachment) const;
+	// Groups of transient attachments that share memory, each used in later subpasses than the previous one
+	const std::vector<std::vector<uint32_t>>& getAliasedAttachments() const { return aliased_attachments; }
 	size_t getSubpassCount() const { return subpass_infos.size(); }
 	const std::vector<VkAttachmentDescription>& getAttachmentDescriptions() const { return attachment_descriptions; }
 	operator const VkRenderPass& () const { return render_pass; }
@@ -67,11 +78,16 @@ public:
 	uint32_t getWidth() const;
 	uint32_t getHeight() const;
 
+private:
+	void aliasTransientAttachments();
+
 private:
 	VkRenderPass render_pass = nullptr;
 	std::vector<SubpassInfo> subpass_infos; 
 	std::vector<VkSubpassDependency> subpass_dependencies;
 	std::vector<VkAttachmentDescription> attachment_descriptions;
+	std::vector<Lifetime> attachment_lifetimes;
+	std::vector<std::vector<uint32_t>> aliased_attachments;
 	std::unordered_set<uint32_t> attachments_used_as_inputs;
 	std::vector<VkClearValue> clear_values;
 	bool any_cleared = false;
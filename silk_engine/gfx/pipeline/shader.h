@@ -1,5 +1,8 @@
 #pragma once
 
+#include "silk_engine/utils/hash_map.h"
+#include "silk_engine/utils/string_id.h"
+
 class DescriptorSetLayout;
 
 namespace spirv_cross
@@ -102,10 +105,10 @@ private:
 	ReflectionData reflection_data{};
 
 public:
-	static shared<Shader> get(std::string_view name) { if (auto it = shaders.find(name); it != shaders.end()) return it->second; return nullptr; }
-	static shared<Shader> add(std::string_view name, const shared<Shader>& shader) { return shaders.insert_or_assign(name, shader).first->second; }
+	static shared<Shader> get(StringId name) { if (auto it = shaders.find(name); it != shaders.end()) return it->second; return nullptr; }
+	static shared<Shader> add(std::string_view name, const shared<Shader>& shader) { return shaders.insert_or_assign(StringId::intern(name), shader).first->second; }
 	static void destroy() { shaders.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<Shader>> shaders{};
+	static inline HashMap<StringId, shared<Shader>> shaders{};
 };
\ No newline at end of file
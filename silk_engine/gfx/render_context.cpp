@@ -18,10 +18,14 @@
 #include "silk_engine/gfx/buffers/command_buffer.h"
 #include "silk_engine/scene/meshes/mesh.h"
 #include "silk_engine/scene/model.h"
+#include "debug/gpu_profiler.h"
+#include "silk_engine/utils/memory_tracker.h"
+#include "silk_engine/utils/frame_statistics.h"
 #include <stb_image_write.h>
 
 void RenderContext::init(std::string_view app_name)
 {
+	allocation_callbacks = MemoryTracker::getVulkanCallbacks();
 	instance = new Instance(app_name);
 	physical_device = instance->selectPhysicalDevice();
 
@@ -40,7 +44,8 @@ void RenderContext::init(std::string_view app_name)
 			HOST_QUERY_RESET,
 			DRAW_INDIRECT_COUNT,
 			MAINTENANCE4,
-			PIPELINE_STATISTICS_QUERY
+			PIPELINE_STATISTICS_QUERY,
+			INHERITED_QUERIES
 		});
 
 	getCommandQueues();
@@ -50,11 +55,13 @@ void RenderContext::init(std::string_view app_name)
 	allocator = new Allocator(*logical_device);
 	pipeline_cache = new PipelineCache();
 	Font::init();
+	GPUProfiler::init();
 }
 
 void RenderContext::destroy()
 {
 	render_graph = nullptr;
+	GPUProfiler::destroy();
 	Model::destroy();
 	Mesh::destroy();
 	Image::destroy();
@@ -65,11 +72,26 @@ void RenderContext::destroy()
 	Sampler::destroy();
 	DescriptorSetLayout::destroy();
 	DescriptorAllocator::destroy();
+	// The device is idle by now, so everything retired can be freed before the allocator goes. Freeing may retire more
+	frame_submissions = {};
+	for (bool retired = true; retired;)
+	{
+		retired = false;
+		for (auto& frame_destructions : deferred_destructions)
+		{
+			std::vector<std::function<void()>> destructions;
+			destructions.swap(frame_destructions);
+			retired |= !destructions.empty();
+			for (auto& destroy : destructions)
+				destroy();
+		}
+	}
 	delete pipeline_cache;
 	delete allocator;
 	command_queues.clear();
 	compute_command_queues.clear();
 	transfer_command_queues.clear();
+	frame_arenas.clear();
 	delete logical_device;
 	delete physical_device;
 	delete instance;
@@ -77,6 +99,24 @@ void RenderContext::destroy()
 
 void RenderContext::update()
 {
+	// Frames are only reused MAX_FRAMES later, so this normally waits on a frame that finished long ago
+	std::vector<std::function<void()>> destructions;
+	{
+		SK_FRAME_STATISTICS_SCOPE("Wait");
+		std::scoped_lock lock(frame_mutex);
+		for (const auto& command_buffer : frame_submissions[frame])
+			if (*command_buffer->getState() == CommandBuffer::State::PENDING)
+				command_buffer->wait();
+		frame_submissions[frame].clear();
+		destructions.swap(deferred_destructions[frame]);
+		// The slot was last used MAX_FRAMES ago, earlier frames were waited on by earlier updates
+		if (frame_number >= MAX_FRAMES)
+			finished_frames = frame_number - MAX_FRAMES + 1;
+	}
+	for (auto& destroy : destructions)
+		destroy();
+
+	std::unique_lock command_queue_lock(command_queue_mutex);
 	for (auto&& [tid, command_queue] : command_queues)
 		command_queue[frame]->reset();
 
@@ -87,8 +127,20 @@ void RenderContext::update()
 	if (physical_device->getTransferQueue() != -1)
 		for (auto&& [tid, command_queue] : transfer_command_queues)
 			command_queue[frame]->reset();
+	command_queue_lock.unlock();
 
 	DescriptorAllocator::reset();
+	GPUProfiler::update();
+
+	std::scoped_lock lock(frame_arena_mutex);
+	for (auto&& [tid, arenas] : frame_arenas)
+		arenas[frame].reset();
+}
+
+void RenderContext::destroyDeferred(std::function<void()>&& destroy)
+{
+	std::scoped_lock lock(frame_mutex);
+	deferred_destructions[frame].emplace_back(std::move(destroy));
 }
 
 void RenderContext::screenshot(const fs::path& file)
@@ -181,39 +233,75 @@ std::string RenderContext::stringifyResult(VkResult result)
 	}
 }
 
+const shared<CommandBuffer>& RenderContext::addFrameSubmission(const shared<CommandBuffer>& command_buffer)
+{
+	std::scoped_lock lock(frame_mutex);
+	frame_submissions[frame].emplace_back(command_buffer);
+	return command_buffer;
+}
+
 const PhysicalDevice& RenderContext::getPhysicalDevice() { return logical_device->getPhysicalDevice(); }
 
+LinearArena& RenderContext::getFrameArena()
+{
+	thread_local std::array<LinearArena, MAX_FRAMES>* arenas = nullptr;
+	if (!arenas)
+	{
+		std::scoped_lock lock(frame_arena_mutex);
+		arenas = &frame_arenas[std::this_thread::get_id()];
+	}
+	return (*arenas)[frame];
+}
+
+// Queues are created the first time a thread records, the calling thread's are cached so only that takes the lock
 const std::vector<shared<CommandQueue>>& RenderContext::getCommandQueues()
 {
+	thread_local const std::vector<shared<CommandQueue>>* queues = nullptr;
+	if (queues)
+		return *queues;
+	std::scoped_lock lock(command_queue_mutex);
 	auto it = command_queues.emplace(std::this_thread::get_id(), std::vector<shared<CommandQueue>>{});
 	if (it.second)
 		for (size_t i = 0; i < MAX_FRAMES; ++i)
 			it.first->second.emplace_back(makeShared<CommandQueue>(physical_device->getGraphicsQueue(), VK_QUEUE_GRAPHICS_BIT));
-	return it.first->second;
+	queues = &it.first->second;
+	return *queues;
 }
 
 const std::vector<shared<CommandQueue>>& RenderContext::getComputeCommandQueues()
 {
+	thread_local const std::vector<shared<CommandQueue>>* queues = nullptr;
+	if (queues)
+		return *queues;
+	const std::vector<shared<CommandQueue>>& graphics_queues = getCommandQueues();
+	std::scoped_lock lock(command_queue_mutex);
 	auto it = compute_command_queues.emplace(std::this_thread::get_id(), std::vector<shared<CommandQueue>>{});
 	if (it.second)
 	{
 		if (physical_device->getComputeQueue() != physical_device->getGraphicsQueue())
 			for (size_t i = 0; i < MAX_FRAMES; ++i)
 				it.first->second.emplace_back(makeShared<CommandQueue>(physical_device->getComputeQueue(), VK_QUEUE_COMPUTE_BIT));
-		else it.first->second = getCommandQueues();
+		else it.first->second = graphics_queues;
 	}
-	return it.first->second;
+	queues = &it.first->second;
+	return *queues;
 }
 
 const std::vector<shared<CommandQueue>>& RenderContext::getTransferCommandQueues()
 {
+	thread_local const std::vector<shared<CommandQueue>>* queues = nullptr;
+	if (queues)
+		return *queues;
+	const std::vector<shared<CommandQueue>>& graphics_queues = getCommandQueues();
+	std::scoped_lock lock(command_queue_mutex);
 	auto it = transfer_command_queues.emplace(std::this_thread::get_id(), std::vector<shared<CommandQueue>>{});
 	if (it.second)
 	{
 		if (physical_device->getTransferQueue() != physical_device->getGraphicsQueue())
 			for (size_t i = 0; i < MAX_FRAMES; ++i)
 				it.first->second.emplace_back(makeShared<CommandQueue>(physical_device->getTransferQueue(), VK_QUEUE_TRANSFER_BIT));
-		else it.first->second = getCommandQueues();
+		else it.first->second = graphics_queues;
 	}
-	return it.first->second;
+	queues = &it.first->second;
+	return *queues;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "command_queue.h"
 #include "devices/physical_device.h"
+#include "silk_engine/utils/linear_arena.h"
 
 class WindowResizeEvent;
 class DebugMessenger;
@@ -20,23 +21,66 @@ class RenderContext
 public:
 	static constexpr size_t MAX_FRAMES = 2;
 
+	// While alive, the calling thread's getCommandBuffer records into the compute queue, so compute work written
+	// against getCommandBuffer (pipelines, materials, descriptor sets) can run on the dedicated compute queue
+	class ComputeScope : NoCopyNoMove
+	{
+	public:
+		ComputeScope()
+			: previous(compute_recording) { compute_recording = true; }
+		~ComputeScope() { compute_recording = previous; }
+
+	private:
+		bool previous = false;
+	};
+
+	// While alive, the calling thread's getCommandBuffer records into command_buffer, so draws written against
+	// getCommandBuffer can be recorded on worker threads into secondary command buffers
+	class RecordScope : NoCopyNoMove
+	{
+	public:
+		RecordScope(CommandBuffer& command_buffer)
+			: previous(recording_command_buffer) { recording_command_buffer = &command_buffer; }
+		~RecordScope() { recording_command_buffer = previous; }
+
+	private:
+		CommandBuffer* previous = nullptr;
+	};
+
 public:
 	static void init(std::string_view app_name);
 	static void destroy();
 	static void update();
-	static void nextFrame() { frame = (frame + 1) % MAX_FRAMES; }
+	static void nextFrame()
+	{
+		frame = (frame + 1) % MAX_FRAMES;
+		++frame_number;
+	}
+	static size_t getFrame() { return frame; }
+	// Counts every frame, unlike getFrame which cycles through the frames in flight
+	static uint64_t getFrameNumber() { return frame_number; }
+	// Frames before this one had all their submissions finish, advanced by update()
+	static uint64_t getFinishedFrames() { return finished_frames; }
 
 	static CommandBuffer& getNewCommandBuffer(bool begin = true)
 	{
-		return getCommandQueues()[frame]->getNewCommandBuffer(begin);
+		return (compute_recording ? getComputeCommandQueues() : getCommandQueues())[frame]->getNewCommandBuffer(begin);
 	}
 	static CommandBuffer& getCommandBuffer(bool begin = true)
 	{
-		return getCommandQueues()[frame]->getCommandBuffer(begin);
+		if (recording_command_buffer)
+			return *recording_command_buffer;
+		return (compute_recording ? getComputeCommandQueues() : getCommandQueues())[frame]->getCommandBuffer(begin);
 	}
+	// From the calling thread's pool, so threads can record secondaries at the same time
+	static CommandBuffer& getSecondaryCommandBuffer()
+	{
+		return getCommandQueues()[frame]->getNewSecondaryCommandBuffer();
+	}
+	// Submissions belong to the current frame, update() waits for them before the frame's resources are reused
 	static const shared<CommandBuffer>& submit(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
-		return getCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores);
+		return addFrameSubmission(getCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores));
 	}
 	static void execute(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
@@ -53,7 +97,7 @@ public:
 	}
 	static const shared<CommandBuffer>& submitCompute(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
-		return getComputeCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores);
+		return addFrameSubmission(getComputeCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores));
 	}
 	static void executeCompute(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
@@ -70,19 +114,25 @@ public:
 	}
 	static const shared<CommandBuffer>& submitTransfer(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
-		return getTransferCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores);
+		return addFrameSubmission(getTransferCommandQueues()[frame]->submit(wait_stages, wait_semaphores, signal_semaphores));
 	}
 	static void executeTransfer(const std::vector<PipelineStage>& wait_stages = {}, const std::vector<VkSemaphore>& wait_semaphores = {}, const std::vector<VkSemaphore>& signal_semaphores = {})
 	{
 		getTransferCommandQueues()[frame]->execute(wait_stages, wait_semaphores, signal_semaphores);
 	}
 
+	// Runs destroy once the frame's submissions finished, by then no frame in flight can still use the object.
+	// Buffers and images are freed through it, so the CPU doesn't wait for the device to release them
+	static void destroyDeferred(std::function<void()>&& destroy);
+
 	static void screenshot(const fs::path& file);
 	static void vulkanAssert(VkResult result);
 	static std::string stringifyResult(VkResult result);
 
 	static void setRenderGraph(const shared<RenderGraph>& render_graph) { RenderContext::render_graph = render_graph; }
 
+	// Used for the instance, device and VMA, other objects keep the default host allocator
+	static const VkAllocationCallbacks* getAllocationCallbacks() { return allocation_callbacks; }
 	static const Instance& getInstance() { return *instance; }
 	static const LogicalDevice& getLogicalDevice() { return *logical_device; }
 	static const PhysicalDevice& getPhysicalDevice();
@@ -90,14 +140,17 @@ public:
 	static const PipelineCache& getPipelineCache() { return *pipeline_cache; }
 	static const RenderGraph& getRenderGraph() { return *render_graph; }
 	static DescriptorAllocator& getDescriptorAllocator() { return *descriptor_allocators[std::this_thread::get_id()][frame]; }
+	// Calling thread's arena for the current frame, reset once the frame's commands finished executing
+	static LinearArena& getFrameArena();
 
 private:
 	static const std::vector<shared<CommandQueue>>& getCommandQueues();
 	static const std::vector<shared<CommandQueue>>& getComputeCommandQueues();
 	static const std::vector<shared<CommandQueue>>& getTransferCommandQueues();
+	static const shared<CommandBuffer>& addFrameSubmission(const shared<CommandBuffer>& command_buffer);
 
 private:
-	static inline VkAllocationCallbacks allocation_callbacks = {}; // TODO: add this everywhere?
+	static inline const VkAllocationCallbacks* allocation_callbacks = nullptr;
 	static inline Instance* instance = nullptr;
 	static inline PhysicalDevice* physical_device = nullptr;
 	static inline LogicalDevice* logical_device = nullptr;
@@ -105,8 +158,18 @@ private:
 	static inline std::unordered_map<std::thread::id, std::vector<shared<CommandQueue>>> command_queues{};
 	static inline std::unordered_map<std::thread::id, std::vector<shared<CommandQueue>>> compute_command_queues{};
 	static inline std::unordered_map<std::thread::id, std::vector<shared<CommandQueue>>> transfer_command_queues{};
+	static inline std::mutex command_queue_mutex;
 	static inline std::unordered_map<std::thread::id, std::vector<shared<DescriptorAllocator>>> descriptor_allocators{};
+	static inline std::unordered_map<std::thread::id, std::array<LinearArena, MAX_FRAMES>> frame_arenas{};
+	static inline std::mutex frame_arena_mutex;
+	static inline std::array<std::vector<shared<CommandBuffer>>, MAX_FRAMES> frame_submissions{};
+	static inline std::array<std::vector<std::function<void()>>, MAX_FRAMES> deferred_destructions{};
+	static inline std::mutex frame_mutex;
 	static inline PipelineCache* pipeline_cache = nullptr;
 	static inline size_t frame = 0;
+	static inline std::atomic<uint64_t> frame_number = 0;
+	static inline std::atomic<uint64_t> finished_frames = 0;
+	static inline thread_local bool compute_recording = false;
+	static inline thread_local CommandBuffer* recording_command_buffer = nullptr;
 	static inline shared<RenderGraph> render_graph = nullptr;
 };
\ No newline at end of file
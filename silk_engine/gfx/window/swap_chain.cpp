@@ -5,6 +5,7 @@
 #include "silk_engine/gfx/window/surface.h"
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/devices/queue.h"
+#include "silk_engine/utils/frame_statistics.h"
 
 SwapChain::SwapChain(const Surface& surface, bool vsync)
 	: surface(surface)
@@ -36,6 +37,7 @@ bool SwapChain::present(VkSemaphore wait_semaphore) const
 	present_info.waitSemaphoreCount = wait_semaphore ? 1 : 0;
 	VkResult result = RenderContext::getLogicalDevice().getPresentQueue(surface).present(present_info);
 	images[image_index]->setLayout(VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+	FrameStatistics::present();
 	if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 		return false;
 	else if (result != VK_SUCCESS)
@@ -1,11 +1,42 @@
-#include "frustum.h"
+#include "frustum_kernels.h"
+#include "silk_engine/utils/cpu.h"
+#include "silk_engine/utils/thread_pool.h"
+#include <immintrin.h>
+
+namespace
+{
+	struct SSE
+	{
+		using F = __m128;
+		static constexpr size_t WIDTH = 4;
+
+		static F load(const float* data) { return _mm_loadu_ps(data); }
+		static F set(float value) { return _mm_set1_ps(value); }
+		static F add(F a, F b) { return _mm_add_ps(a, b); }
+		static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+		static F max(F a, F b) { return _mm_max_ps(a, b); }
+		static F ge(F a, F b) { return _mm_cmpge_ps(a, b); }
+		static F both(F a, F b) { return _mm_and_ps(a, b); }
+		static uint64_t mask(F a) { return uint64_t(_mm_movemask_ps(a)); }
+	};
+
+	bool isObjectVisible(const Frustum& frustum, const Frustum::Boxes& boxes, size_t i)
+	{
+		return frustum.isBoxVisible(vec3(boxes.min_x[i], boxes.min_y[i], boxes.min_z[i]), vec3(boxes.max_x[i], boxes.max_y[i], boxes.max_z[i]));
+	}
+
+	bool isObjectVisible(const Frustum& frustum, const Frustum::Spheres& spheres, size_t i)
+	{
+		return frustum.isSphereVisible(vec3(spheres.x[i], spheres.y[i], spheres.z[i]), spheres.radius[i]);
+	}
+}
 
 Frustum::Frustum(const mat4& projection_view)
 {
 	calculatePlanes(projection_view);
 }
 
-void Frustum::calculatePlanes(const mat4& projection_view) 
+void Frustum::calculatePlanes(const mat4& projection_view)
 {
 	const mat4 projection_view_t = math::transpose(projection_view);
 	planes[LEFT] = projection_view_t[3] + projection_view_t[0];
@@ -14,19 +45,66 @@ void Frustum::calculatePlanes(const mat4& projection_view)
 	planes[TOP] = projection_view_t[3] - projection_view_t[1];
 	planes[NEAR] = projection_view_t[3] + projection_view_t[2];
 	planes[FAR] = projection_view_t[3] - projection_view_t[2];
+	// Normalized so plane distances are in world units, which sphere tests need
+	for (vec4& plane : planes)
+		plane /= math::length(vec3(plane));
 }
 
 bool Frustum::isBoxVisible(const vec3& min, const vec3& max) const
 {
-	for (size_t i = 0; i < COUNT; ++i)
-		if (math::dot(planes[i], vec4(min.x, min.y, min.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(max.x, min.y, min.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(min.x, max.y, min.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(max.x, max.y, min.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(min.x, min.y, max.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(max.x, min.y, max.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(min.x, max.y, max.z, 1.0f)) < 0.0f &&
-			math::dot(planes[i], vec4(max.x, max.y, max.z, 1.0f)) < 0.0f)
+	for (const vec4& plane : planes)
+		if (std::max(plane.x * min.x, plane.x * max.x) + std::max(plane.y * min.y, plane.y * max.y) + std::max(plane.z * min.z, plane.z * max.z) + plane.w < 0.0f)
+			return false;
+	return true;
+}
+
+bool Frustum::isSphereVisible(const vec3& center, float radius) const
+{
+	for (const vec4& plane : planes)
+		if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
 			return false;
 	return true;
+}
+
+void Frustum::cull(const Boxes& boxes, std::span<uint64_t> visible) const
+{
+	cull(nullptr, boxes, visible);
+}
+
+void Frustum::cull(const Spheres& spheres, std::span<uint64_t> visible) const
+{
+	cull(nullptr, spheres, visible);
+}
+
+void Frustum::cull(ThreadPool& pool, const Boxes& boxes, std::span<uint64_t> visible) const
+{
+	cull(&pool, boxes, visible);
+}
+
+void Frustum::cull(ThreadPool& pool, const Spheres& spheres, std::span<uint64_t> visible) const
+{
+	cull(&pool, spheres, visible);
+}
+
+template<typename Bounds>
+void Frustum::cull(ThreadPool* pool, const Bounds& bounds, std::span<uint64_t> visible) const
+{
+	size_t count = bounds.size();
+	SK_ASSERT(visible.size() >= getMaskSize(count), "Frustum: Visibility mask is too small");
+
+	// Ranges start at multiples of 64, so every mask word is written by a single range
+	auto cullRange = [&](size_t begin, size_t end)
+	{
+		std::fill(visible.begin() + begin / 64, visible.begin() + getMaskSize(end), 0);
+		size_t i = CPU::getSimdLevel() == CPU::SimdLevel::AVX2 ? Kernels::testGroupsAVX2(planes, bounds, begin, end, visible) : Kernels::testGroups<SSE>(planes, bounds, begin, end, visible);
+		for (; i < end; ++i)
+			visible[i / 64] |= uint64_t(isObjectVisible(*this, bounds, i)) << (i % 64);
+	};
+
+	if (!pool || count <= BLOCK_SIZE)
+	{
+		cullRange(0, count);
+		return;
+	}
+	pool->parallelFor((count + BLOCK_SIZE - 1) / BLOCK_SIZE, [&](size_t block) { cullRange(block * BLOCK_SIZE, std::min((block + 1) * BLOCK_SIZE, count)); }, 1);
 }
\ No newline at end of file
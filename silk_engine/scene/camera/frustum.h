@@ -1,7 +1,30 @@
 #pragma once
 
+class ThreadPool;
+
 class Frustum
 {
+public:
+	// Structure of arrays bounds, object i is made of the i-th element of every span
+	struct Boxes
+	{
+		std::span<const float> min_x, min_y, min_z;
+		std::span<const float> max_x, max_y, max_z;
+
+		size_t size() const { return min_x.size(); }
+	};
+
+	struct Spheres
+	{
+		std::span<const float> x, y, z;
+		std::span<const float> radius;
+
+		size_t size() const { return x.size(); }
+	};
+
+	// Objects per task when culling on a thread pool, a multiple of the 64 objects in every mask word
+	static constexpr size_t BLOCK_SIZE = 1024;
+
 private:
 #undef NEAR
 #undef FAR
@@ -24,8 +47,27 @@ public:
 	Frustum(const mat4& projection_view);
 	void calculatePlanes(const mat4& projection_view);
 	bool isBoxVisible(const vec3& min, const vec3& max) const;
+	bool isSphereVisible(const vec3& center, float radius) const;
+
+	// Sets bit i % 64 of visible[i / 64] when object i is at least partly inside, and clears it otherwise.
+	// Tests 8 (AVX2) or 4 (SSE) objects at once, against the vertex of the box furthest along each plane normal
+	void cull(const Boxes& boxes, std::span<uint64_t> visible) const;
+	void cull(const Spheres& spheres, std::span<uint64_t> visible) const;
+	// Same as above, split into blocks of BLOCK_SIZE objects culled on the pool's threads
+	void cull(ThreadPool& pool, const Boxes& boxes, std::span<uint64_t> visible) const;
+	void cull(ThreadPool& pool, const Spheres& spheres, std::span<uint64_t> visible) const;
+
+	static size_t getMaskSize(size_t count) { return (count + 63) / 64; }
+	static bool isVisible(std::span<const uint64_t> visible, size_t index) { return (visible[index / 64] >> (index % 64)) & 1; }
+
 	std::array<vec4, COUNT> getPlanes() const { return planes; }
 
+private:
+	struct Kernels;
+
+	template<typename Bounds>
+	void cull(ThreadPool* pool, const Bounds& bounds, std::span<uint64_t> visible) const;
+
 private:
 	std::array<vec4, COUNT> planes;
 };
\ No newline at end of file
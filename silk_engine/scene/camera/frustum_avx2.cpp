@@ -0,0 +1,31 @@
+#include "silk_engine/core/base.h" // Built without the precompiled header, see CMakeLists.txt
+#include "frustum_kernels.h"
+#include <immintrin.h>
+
+namespace
+{
+	struct AVX2
+	{
+		using F = __m256;
+		static constexpr size_t WIDTH = 8;
+
+		static F load(const float* data) { return _mm256_loadu_ps(data); }
+		static F set(float value) { return _mm256_set1_ps(value); }
+		static F add(F a, F b) { return _mm256_add_ps(a, b); }
+		static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+		static F max(F a, F b) { return _mm256_max_ps(a, b); }
+		static F ge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+		static F both(F a, F b) { return _mm256_and_ps(a, b); }
+		static uint64_t mask(F a) { return uint64_t(_mm256_movemask_ps(a)); }
+	};
+}
+
+size_t Frustum::Kernels::testGroupsAVX2(std::span<const vec4> planes, const Boxes& boxes, size_t begin, size_t end, std::span<uint64_t> visible)
+{
+	return testGroups<AVX2>(planes, boxes, begin, end, visible);
+}
+
+size_t Frustum::Kernels::testGroupsAVX2(std::span<const vec4> planes, const Spheres& spheres, size_t begin, size_t end, std::span<uint64_t> visible)
+{
+	return testGroups<AVX2>(planes, spheres, begin, end, visible);
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "frustum.h"
+
+// Culling written once against an instruction set wrapper V. SSE is part of the x64 baseline and used from
+// frustum.cpp, AVX2 lives in frustum_avx2.cpp, the only file built for it
+struct Frustum::Kernels
+{
+	// One bit per box, set when the p-vertex (the corner furthest along the plane normal) is inside every plane
+	template<typename V>
+	static uint64_t test(std::span<const vec4> planes, const Boxes& boxes, size_t i)
+	{
+		using F = typename V::F;
+		F min_x = V::load(boxes.min_x.data() + i), max_x = V::load(boxes.max_x.data() + i);
+		F min_y = V::load(boxes.min_y.data() + i), max_y = V::load(boxes.max_y.data() + i);
+		F min_z = V::load(boxes.min_z.data() + i), max_z = V::load(boxes.max_z.data() + i);
+		F inside{};
+		for (size_t p = 0; p < planes.size(); ++p)
+		{
+			F a = V::set(planes[p].x), b = V::set(planes[p].y), c = V::set(planes[p].z);
+			F distance = V::add(V::add(V::add(V::max(V::mul(a, min_x), V::mul(a, max_x)), V::max(V::mul(b, min_y), V::mul(b, max_y))), V::max(V::mul(c, min_z), V::mul(c, max_z))), V::set(planes[p].w));
+			F plane_inside = V::ge(distance, V::set(0.0f));
+			inside = p ? V::both(inside, plane_inside) : plane_inside;
+		}
+		return V::mask(inside);
+	}
+
+	template<typename V>
+	static uint64_t test(std::span<const vec4> planes, const Spheres& spheres, size_t i)
+	{
+		using F = typename V::F;
+		F x = V::load(spheres.x.data() + i);
+		F y = V::load(spheres.y.data() + i);
+		F z = V::load(spheres.z.data() + i);
+		F radius = V::mul(V::load(spheres.radius.data() + i), V::set(-1.0f));
+		F inside{};
+		for (size_t p = 0; p < planes.size(); ++p)
+		{
+			F distance = V::add(V::add(V::add(V::mul(V::set(planes[p].x), x), V::mul(V::set(planes[p].y), y)), V::mul(V::set(planes[p].z), z)), V::set(planes[p].w));
+			F plane_inside = V::ge(distance, radius);
+			inside = p ? V::both(inside, plane_inside) : plane_inside;
+		}
+		return V::mask(inside);
+	}
+
+	// Tests whole groups from begin, which is a multiple of 64, and returns where the remaining objects start
+	template<typename V, typename Bounds>
+	static size_t testGroups(std::span<const vec4> planes, const Bounds& bounds, size_t begin, size_t end, std::span<uint64_t> visible)
+	{
+		size_t i = begin;
+		for (; i + V::WIDTH <= end; i += V::WIDTH)
+			visible[i / 64] |= test<V>(planes, bounds, i) << (i % 64);
+		return i;
+	}
+
+	static size_t testGroupsAVX2(std::span<const vec4> planes, const Boxes& boxes, size_t begin, size_t end, std::span<uint64_t> visible);
+	static size_t testGroupsAVX2(std::span<const vec4> planes, const Spheres& spheres, size_t begin, size_t end, std::span<uint64_t> visible);
+};
\ No newline at end of file
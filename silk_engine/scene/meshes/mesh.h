@@ -1,6 +1,8 @@
 #pragma once
 
 #include "silk_engine/gfx/buffers/vertex_array.h"
+#include "silk_engine/utils/hash_map.h"
+#include "silk_engine/utils/string_id.h"
 
 struct RawMesh;
 
@@ -10,15 +12,15 @@ public:
 	using VertexArray::VertexArray;
 
 public:
-	static shared<Mesh> get(std::string_view name) 
+	static shared<Mesh> get(StringId name) 
 	{ 
 		if (auto it = meshes.find(name); it != meshes.end()) 
 			return it->second; 
 		return nullptr; 
 	}
-	static shared<Mesh> add(std::string_view name, const shared<Mesh>& mesh) { return meshes.insert_or_assign(name, mesh).first->second; }
+	static shared<Mesh> add(std::string_view name, const shared<Mesh>& mesh) { return meshes.insert_or_assign(StringId::intern(name), mesh).first->second; }
 	static void destroy() { meshes.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<Mesh>> meshes{};
+	static inline HashMap<StringId, shared<Mesh>> meshes{};
 };
\ No newline at end of file
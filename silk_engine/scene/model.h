@@ -1,6 +1,8 @@
 #pragma once
 
 #include "raw_model.h"
+#include "silk_engine/utils/hash_map.h"
+#include "silk_engine/utils/string_id.h"
 
 class Mesh;
 class Image;
@@ -26,15 +28,15 @@ private:
 	fs::path file;
 
 public:
-	static shared<Model> get(std::string_view name) 
+	static shared<Model> get(StringId name) 
 	{ 
 		if (auto it = models.find(name); it != models.end()) 
 			return it->second; 
 		return nullptr; 
 	}
-	static shared<Model> add(std::string_view name, const shared<Model>& model) { return models.insert_or_assign(name, model).first->second; }
+	static shared<Model> add(std::string_view name, const shared<Model>& model) { return models.insert_or_assign(StringId::intern(name), model).first->second; }
 	static void destroy() { models.clear(); }
 
 private:
-	static inline std::unordered_map<std::string_view, shared<Model>> models{};
+	static inline HashMap<StringId, shared<Model>> models{};
 };
\ No newline at end of file
@@ -0,0 +1,326 @@
+#pragma once
+
+// Lets one side of a queue park until the other side makes progress, without a mutex on the fast path:
+// the side making progress only pays a fence and a load unless someone is actually waiting
+class QueueSignal : NoCopy
+{
+public:
+    void notify()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed))
+        {
+            ++epoch;
+            epoch.notify_all();
+        }
+    }
+
+    // Retries function until it returns true, parking between attempts
+    template<typename Fn>
+    void waitUntil(Fn&& function)
+    {
+        for (size_t spin = 0; spin < SPIN_COUNT; ++spin)
+        {
+            if (function())
+                return;
+            std::this_thread::yield();
+        }
+        while (true)
+        {
+            ++waiters;
+            // Pairs with the fence in notify(): either the notifier sees the waiter or function() sees its progress
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            uint32_t observed = epoch.load();
+            bool done = function();
+            if (!done)
+                epoch.wait(observed);
+            --waiters;
+            if (done)
+                return;
+        }
+    }
+
+private:
+    static constexpr size_t SPIN_COUNT = 16;
+
+private:
+    std::atomic<uint32_t> epoch = 0;
+    std::atomic<uint32_t> waiters = 0;
+};
+
+// Bounded single producer, single consumer ring buffer
+template<typename T>
+class SPSCQueue : NoCopy
+{
+public:
+    // @param capacity rounded up to a power of 2
+    SPSCQueue(size_t capacity)
+        : capacity(std::bit_ceil(std::max(capacity, size_t(2)))), mask(this->capacity - 1),
+        items(scast<T*>(::operator new(this->capacity * sizeof(T), std::align_val_t(alignof(T))))) {}
+    ~SPSCQueue()
+    {
+        for (size_t i = head.load(); i != tail.load(); ++i)
+            items[i & mask].~T();
+        ::operator delete(items, std::align_val_t(alignof(T)));
+    }
+
+    // Producer only
+    template<typename... Args>
+    bool tryEmplace(Args&&... args)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cached_head == capacity && t - (cached_head = head.load(std::memory_order_acquire)) == capacity)
+            return false;
+        new (items + (t & mask)) T(std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        pop_signal.notify();
+        return true;
+    }
+    bool tryPush(const T& item) { return tryEmplace(item); }
+    bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+    // Producer only, blocks while full
+    void push(T item) { push_signal.waitUntil([&] { return tryEmplace(std::move(item)); }); }
+
+    // Producer only, pushes as many items as fit
+    // @return number of items pushed
+    size_t tryPush(std::span<const T> batch)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        cached_head = head.load(std::memory_order_acquire);
+        size_t count = std::min(batch.size(), capacity - (t - cached_head));
+        for (size_t i = 0; i < count; ++i)
+            new (items + ((t + i) & mask)) T(batch[i]);
+        if (!count)
+            return 0;
+        tail.store(t + count, std::memory_order_release);
+        pop_signal.notify();
+        return count;
+    }
+
+    // Consumer only
+    bool tryPop(T& item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cached_tail && h == (cached_tail = tail.load(std::memory_order_acquire)))
+            return false;
+        T* slot = items + (h & mask);
+        item = std::move(*slot);
+        slot->~T();
+        head.store(h + 1, std::memory_order_release);
+        push_signal.notify();
+        return true;
+    }
+
+    // Consumer only, blocks while empty
+    T pop()
+    {
+        T item;
+        pop_signal.waitUntil([&] { return tryPop(item); });
+        return item;
+    }
+
+    // Consumer only, pops as many items as available and fit in batch
+    // @return number of items popped
+    size_t tryPop(std::span<T> batch)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        cached_tail = tail.load(std::memory_order_acquire);
+        size_t count = std::min(batch.size(), cached_tail - h);
+        for (size_t i = 0; i < count; ++i)
+        {
+            T* slot = items + ((h + i) & mask);
+            batch[i] = std::move(*slot);
+            slot->~T();
+        }
+        if (!count)
+            return 0;
+        head.store(h + count, std::memory_order_release);
+        push_signal.notify();
+        return count;
+    }
+
+    size_t size() const { return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_relaxed); }
+    bool empty() const { return !size(); }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    const size_t capacity = 0;
+    const size_t mask = 0;
+    T* items = nullptr;
+
+    alignas(64) std::atomic<size_t> head = 0;
+    size_t cached_tail = 0; // Consumer's copy of tail
+    alignas(64) std::atomic<size_t> tail = 0;
+    size_t cached_head = 0; // Producer's copy of head
+    alignas(64) QueueSignal push_signal;
+    QueueSignal pop_signal;
+};
+
+// Bounded multi producer, multi consumer ring buffer.
+// Every cell has a sequence number telling whether it's ready to be written or read at the current lap
+// (Dmitry Vyukov's bounded MPMC queue), so producers and consumers only contend on their own index
+template<typename T>
+class MPMCQueue : NoCopy
+{
+private:
+    struct alignas(64) Cell
+    {
+        std::atomic<size_t> sequence = 0;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        T* get() { return std::launder(rcast<T*>(storage)); }
+    };
+
+public:
+    // @param capacity rounded up to a power of 2
+    MPMCQueue(size_t capacity)
+        : capacity(std::bit_ceil(std::max(capacity, size_t(2)))), mask(this->capacity - 1), cells(new Cell[this->capacity])
+    {
+        for (size_t i = 0; i < this->capacity; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    ~MPMCQueue()
+    {
+        while (tryConsumeNoNotify([](T&) {}));
+    }
+
+    template<typename... Args>
+    bool tryEmplace(Args&&... args)
+    {
+        if (!tryEmplaceNoNotify(std::forward<Args>(args)...))
+            return false;
+        pop_signal.notify();
+        return true;
+    }
+    bool tryPush(const T& item) { return tryEmplace(item); }
+    bool tryPush(T&& item) { return tryEmplace(std::move(item)); }
+
+    // Blocks while full
+    void push(T item) { push_signal.waitUntil([&] { return tryEmplace(std::move(item)); }); }
+
+    // Blocks while full, args are only consumed once a cell is claimed
+    template<typename... Args>
+    void emplace(Args&&... args) { push_signal.waitUntil([&] { return tryEmplace(std::forward<Args>(args)...); }); }
+
+    // Pushes items until full, other producers' items may be interleaved
+    // @return number of items pushed
+    size_t tryPush(std::span<const T> batch)
+    {
+        size_t count = 0;
+        while (count < batch.size() && tryEmplaceNoNotify(batch[count]))
+            ++count;
+        if (count)
+            pop_signal.notify();
+        return count;
+    }
+
+    bool tryPop(T& item)
+    {
+        return tryConsume([&](T& popped) { item = std::move(popped); });
+    }
+
+    // Pops an item and passes it to function(T&) in place, for items that aren't default constructible or assignable
+    template<typename Fn>
+    bool tryConsume(Fn&& function)
+    {
+        if (!tryConsumeNoNotify(function))
+            return false;
+        push_signal.notify();
+        return true;
+    }
+
+    // Blocks while empty
+    T pop()
+    {
+        T item;
+        pop_signal.waitUntil([&] { return tryPop(item); });
+        return item;
+    }
+
+    // Blocks while empty
+    template<typename Fn>
+    void consume(Fn&& function) { pop_signal.waitUntil([&] { return tryConsume(function); }); }
+
+    // Pops items until empty or batch is filled
+    // @return number of items popped
+    size_t tryPop(std::span<T> batch)
+    {
+        size_t count = 0;
+        while (count < batch.size() && tryConsumeNoNotify([&](T& popped) { batch[count] = std::move(popped); }))
+            ++count;
+        if (count)
+            push_signal.notify();
+        return count;
+    }
+
+    // Approximate while other threads push or pop
+    size_t size() const
+    {
+        size_t pushed = enqueue_position.load(std::memory_order_relaxed);
+        size_t popped = dequeue_position.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+    bool empty() const { return !size(); }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    template<typename... Args>
+    bool tryEmplaceNoNotify(Args&&... args)
+    {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position);
+            if (difference == 0)
+            {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; // Cell still holds an item from the previous lap
+            else position = enqueue_position.load(std::memory_order_relaxed);
+        }
+        new (cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    template<typename Fn>
+    bool tryConsumeNoNotify(Fn&& function)
+    {
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        while (true)
+        {
+            cell = &cells[position & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = intptr_t(sequence) - intptr_t(position + 1);
+            if (difference == 0)
+            {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+                return false; // Cell wasn't written yet at this lap
+            else position = dequeue_position.load(std::memory_order_relaxed);
+        }
+        function(*cell->get());
+        cell->get()->~T();
+        cell->sequence.store(position + capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    const size_t capacity = 0;
+    const size_t mask = 0;
+    unique<Cell[]> cells = nullptr;
+
+    alignas(64) std::atomic<size_t> enqueue_position = 0;
+    alignas(64) std::atomic<size_t> dequeue_position = 0;
+    alignas(64) QueueSignal push_signal;
+    QueueSignal pop_signal;
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "cpu.h"
+#ifdef _MSC_VER
+    #include <intrin.h>
+#else
+    #include <immintrin.h>
+#endif
+
+CPU::SimdLevel CPU::getSimdLevel()
+{
+    return std::min(getSupportedSimdLevel(), simd_level_limit.load(std::memory_order_relaxed));
+}
+
+CPU::SimdLevel CPU::getSupportedSimdLevel()
+{
+    static const SimdLevel level = []
+    {
+#ifdef _MSC_VER
+        int info[4] = {};
+        __cpuid(info, 1);
+        bool sse41 = info[2] & (1 << 19);
+        bool avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6; // OS saves YMM registers
+        __cpuidex(info, 7, 0);
+        bool avx2 = avx && (info[1] & (1 << 5));
+#else
+        bool sse41 = __builtin_cpu_supports("sse4.1");
+        bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        return avx2 ? SimdLevel::AVX2 : sse41 ? SimdLevel::SSE41 : SimdLevel::SCALAR;
+    }();
+    return level;
+}
\ No newline at end of file
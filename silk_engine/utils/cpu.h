@@ -0,0 +1,24 @@
+#pragma once
+
+// Instruction set support of the running CPU, for kernels that pick a SIMD path at runtime
+class CPU
+{
+public:
+    enum class SimdLevel
+    {
+        SCALAR,
+        SSE41,
+        AVX2
+    };
+
+public:
+    // Detected once, then cached, and capped by setSimdLevel
+    static SimdLevel getSimdLevel();
+    static SimdLevel getSupportedSimdLevel();
+    // Caps the level kernels use, so tests can run every path the CPU supports. Levels above the supported one
+    // fall back to it
+    static void setSimdLevel(SimdLevel level) { simd_level_limit.store(level, std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<SimdLevel> simd_level_limit = SimdLevel::AVX2;
+};
\ No newline at end of file
@@ -0,0 +1,235 @@
+#include "frame_statistics.h"
+#include "silk_engine/io/file.h"
+#include "string.h"
+
+std::vector<FrameStatistics::Metric> FrameStatistics::metrics = { Metric{ "CPU" }, Metric{ "GPU" }, Metric{ "Present" } };
+
+void FrameStatistics::Histogram::push(double value)
+{
+    if (count == WINDOW)
+    {
+        --buckets[getBucket(samples[head])];
+        sum -= samples[head];
+    }
+    else ++count;
+    samples[head] = float(value);
+    ++buckets[getBucket(samples[head])];
+    sum += samples[head];
+    head = (head + 1) % WINDOW;
+}
+
+double FrameStatistics::Histogram::getPercentile(double percentile) const
+{
+    if (!count)
+        return 0.0;
+    size_t rank = std::max(size_t(std::ceil(percentile * count)), size_t(1));
+    size_t seen = 0;
+    for (uint32_t bucket = 0; bucket < BUCKETS; ++bucket)
+    {
+        seen += buckets[bucket];
+        if (seen >= rank)
+            return getBucketValue(bucket);
+    }
+    return getBucketValue(BUCKETS - 1);
+}
+
+FrameStatistics::Summary FrameStatistics::Histogram::getSummary() const
+{
+    Summary summary{};
+    if (!count)
+        return summary;
+    summary.samples = count;
+    summary.average = sum / count;
+    summary.max = *std::max_element(samples.begin(), samples.begin() + count);
+    // Bucket values are approximate, keep them consistent with the exact max
+    summary.p50 = std::min(getPercentile(0.50), summary.max);
+    summary.p95 = std::min(getPercentile(0.95), summary.max);
+    summary.p99 = std::min(getPercentile(0.99), summary.max);
+    return summary;
+}
+
+uint32_t FrameStatistics::Histogram::getBucket(double value)
+{
+    if (!(value > MIN))
+        return 0;
+    return std::min(uint32_t(std::log2(value / MIN) * SUB_BUCKETS), BUCKETS - 1);
+}
+
+double FrameStatistics::Histogram::getBucketValue(uint32_t bucket)
+{
+    // Middle of the bucket in log space
+    return MIN * std::exp2((bucket + 0.5) / SUB_BUCKETS);
+}
+
+void FrameStatistics::beginFrame()
+{
+    frame_start = Time::getHighResTime();
+}
+
+void FrameStatistics::endFrame()
+{
+    add(CPU, (Time::getHighResTime() - frame_start) * 1000.0);
+
+    std::scoped_lock lock(mutex);
+    Frame* frame = recording ? &run.emplace_back(Frame{ Time::frame, Time::runtime }) : nullptr;
+    if (frame)
+        frame->values.resize(metrics.size(), std::numeric_limits<float>::quiet_NaN());
+    for (size_t i = 0; i < metrics.size(); ++i)
+    {
+        Metric& metric = metrics[i];
+        double value = std::numeric_limits<double>::quiet_NaN();
+        if (metric.has_frame_value)
+        {
+            metric.histogram.push(metric.frame_value);
+            value = metric.frame_value;
+            metric.frame_value = 0.0;
+            metric.has_frame_value = false;
+        }
+        if (!std::isnan(metric.late_value))
+        {
+            value = metric.late_value;
+            metric.late_value = std::numeric_limits<double>::quiet_NaN();
+        }
+        if (frame)
+            frame->values[i] = float(value);
+    }
+}
+
+void FrameStatistics::present()
+{
+    double now = Time::getHighResTime();
+    if (last_present > 0.0)
+        add(PRESENT, (now - last_present) * 1000.0);
+    last_present = now;
+}
+
+void FrameStatistics::add(uint32_t metric, double milliseconds)
+{
+    std::scoped_lock lock(mutex);
+    metrics[metric].frame_value += milliseconds;
+    metrics[metric].has_frame_value = true;
+}
+
+void FrameStatistics::record(uint32_t metric, double milliseconds)
+{
+    std::scoped_lock lock(mutex);
+    metrics[metric].histogram.push(milliseconds);
+    metrics[metric].late_value = milliseconds;
+}
+
+void FrameStatistics::startRun()
+{
+    std::scoped_lock lock(mutex);
+    run.clear();
+    recording = true;
+}
+
+void FrameStatistics::stopRun()
+{
+    recording = false;
+}
+
+void FrameStatistics::save(const fs::path& file)
+{
+    std::scoped_lock lock(mutex);
+
+    // Run summaries are exact, computed from every recorded frame rather than the rolling histograms
+    std::vector<Summary> summaries(metrics.size());
+    std::vector<float> values;
+    for (size_t i = 0; i < metrics.size(); ++i)
+    {
+        values.clear();
+        for (const auto& frame : run)
+            if (i < frame.values.size() && !std::isnan(frame.values[i]))
+                values.emplace_back(frame.values[i]);
+        if (values.empty())
+            continue;
+        std::sort(values.begin(), values.end());
+        auto percentile = [&](double p) { return double(values[std::min(size_t(std::ceil(p * values.size())), values.size()) - 1]); };
+        Summary& summary = summaries[i];
+        summary.samples = values.size();
+        summary.average = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        summary.p50 = percentile(0.50);
+        summary.p95 = percentile(0.95);
+        summary.p99 = percentile(0.99);
+        summary.max = values.back();
+    }
+
+    auto value = [](const Frame& frame, size_t metric, std::string_view none)
+    {
+        if (metric >= frame.values.size() || std::isnan(frame.values[metric]))
+            return std::string(none);
+        return std::format("{:.4f}", frame.values[metric]);
+    };
+
+    std::string text;
+    if (file.extension() == ".json")
+    {
+        text = "{\n\"summary\":{\n";
+        for (size_t i = 0; i < metrics.size(); ++i)
+        {
+            const Summary& summary = summaries[i];
+            text += std::format("\"{}\":{{\"samples\":{},\"average\":{:.4f},\"p50\":{:.4f},\"p95\":{:.4f},\"p99\":{:.4f},\"max\":{:.4f}}}{}\n",
+                String::escapeJson(metrics[i].name), summary.samples, summary.average, summary.p50, summary.p95, summary.p99, summary.max, i + 1 < metrics.size() ? "," : "");
+        }
+        text += "},\n\"metrics\":[";
+        for (size_t i = 0; i < metrics.size(); ++i)
+            text += std::format("\"{}\"{}", String::escapeJson(metrics[i].name), i + 1 < metrics.size() ? "," : "");
+        text += "],\n\"frames\":[\n";
+        for (size_t f = 0; f < run.size(); ++f)
+        {
+            text += std::format("[{},{:.6f}", run[f].index, run[f].time);
+            for (size_t i = 0; i < metrics.size(); ++i)
+                text += "," + value(run[f], i, "null");
+            text += f + 1 < run.size() ? "],\n" : "]\n";
+        }
+        text += "]\n}";
+    }
+    else
+    {
+        text = "\"frame\",\"time\"";
+        for (const auto& metric : metrics)
+            text += "," + String::quoteCsv(metric.name);
+        text += "\n";
+        for (const auto& frame : run)
+        {
+            text += std::format("{},{:.6f}", frame.index, frame.time);
+            for (size_t i = 0; i < metrics.size(); ++i)
+                text += "," + value(frame, i, "");
+            text += "\n";
+        }
+    }
+
+    if (!File::directory(file).empty() && !fs::exists(File::directory(file)))
+        fs::create_directories(File::directory(file));
+    File::write(file, text.data(), text.size());
+    SK_INFO("Frame statistics saved at {} ({} frames)", file, run.size());
+    for (size_t i = 0; i < metrics.size(); ++i)
+        if (summaries[i].samples)
+            SK_INFO("{}: avg {:.3f} ms, p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms", metrics[i].name, summaries[i].average, summaries[i].p50, summaries[i].p95, summaries[i].p99, summaries[i].max);
+}
+
+uint32_t FrameStatistics::getMetric(std::string_view name)
+{
+    std::scoped_lock lock(mutex);
+    for (size_t i = 0; i < metrics.size(); ++i)
+        if (metrics[i].name == name)
+            return uint32_t(i);
+    metrics.emplace_back(Metric{ std::string(name) });
+    return uint32_t(metrics.size() - 1);
+}
+
+FrameStatistics::Summary FrameStatistics::getSummary(uint32_t metric)
+{
+    std::scoped_lock lock(mutex);
+    return metrics[metric].histogram.getSummary();
+}
+
+std::vector<std::string> FrameStatistics::getMetricNames()
+{
+    std::scoped_lock lock(mutex);
+    std::vector<std::string> names;
+    for (const auto& metric : metrics)
+        names.emplace_back(metric.name);
+    return names;
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+// Collects per frame timings in milliseconds: CPU frame time, GPU frame time, present interval and named stages.
+// Every metric keeps a rolling histogram over the last WINDOW samples for live p50/p95/p99/max, and while a run
+// is recording every frame is also kept so it can be saved as CSV or JSON and compared between builds offline
+class FrameStatistics
+{
+public:
+    static constexpr size_t WINDOW = 1024; // Frames the rolling histograms cover
+    static constexpr uint32_t CPU = 0; // Main loop iteration
+    static constexpr uint32_t GPU = 1; // First to last GPUProfiler timestamp of a frame, arrives frames in flight late
+    static constexpr uint32_t PRESENT = 2; // Interval between presents
+
+    struct Summary
+    {
+        double average = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double p99 = 0.0;
+        double max = 0.0;
+        size_t samples = 0;
+    };
+
+    // Log-linear buckets (16 per power of two, ~4% wide) from 1us to ~1min, over a ring of the latest samples
+    class Histogram
+    {
+    public:
+        static constexpr uint32_t SUB_BUCKETS = 16;
+        static constexpr uint32_t BUCKETS = 26 * SUB_BUCKETS;
+        static constexpr double MIN = 0.001;
+
+    public:
+        void push(double value);
+        // @param percentile in [0, 1]
+        double getPercentile(double percentile) const;
+        Summary getSummary() const;
+        size_t getCount() const { return count; }
+
+    private:
+        static uint32_t getBucket(double value);
+        static double getBucketValue(uint32_t bucket);
+
+    private:
+        std::array<float, WINDOW> samples = {};
+        std::array<uint32_t, BUCKETS> buckets = {};
+        size_t head = 0;
+        size_t count = 0;
+        double sum = 0.0;
+    };
+
+    // Adds the time between construction and destruction to a stage of the current frame.
+    // Use SK_FRAME_STATISTICS_SCOPE, it looks the metric up once per call site instead of on every construction
+    class Scope : NoCopyNoMove
+    {
+    public:
+        Scope(uint32_t metric)
+            : metric(metric), start(Time::getHighResTime()) {}
+        ~Scope() { FrameStatistics::add(metric, (Time::getHighResTime() - start) * 1000.0); }
+
+    private:
+        uint32_t metric = 0;
+        double start = 0.0;
+    };
+
+public:
+    static void beginFrame();
+    static void endFrame();
+    static void present();
+    // Adds to the current frame's value of the metric, pushed to its histogram at endFrame()
+    static void add(uint32_t metric, double milliseconds);
+    // Pushes a sample straight away, for values that arrive after their frame ended like GPU time
+    static void record(uint32_t metric, double milliseconds);
+
+    static void startRun();
+    static void stopRun();
+    // Writes the recorded run with a summary per metric, as JSON if the extension is .json and CSV otherwise
+    static void save(const fs::path& file);
+    static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+
+    // Registers the metric if it doesn't exist yet
+    static uint32_t getMetric(std::string_view name);
+    static Summary getSummary(uint32_t metric);
+    static std::vector<std::string> getMetricNames();
+
+private:
+    struct Metric
+    {
+        std::string name;
+        Histogram histogram = {};
+        double frame_value = 0.0;
+        bool has_frame_value = false;
+        double late_value = std::numeric_limits<double>::quiet_NaN(); // Recorded value, only kept for the run
+    };
+
+    struct Frame
+    {
+        uint64_t index = 0;
+        double time = 0.0;
+        std::vector<float> values; // NaN for metrics without a sample that frame
+    };
+
+private:
+    static std::vector<Metric> metrics;
+    static inline std::vector<Frame> run;
+    static inline double frame_start = 0.0;
+    static inline double last_present = 0.0;
+    static inline std::atomic<bool> recording = false;
+    static inline std::mutex mutex;
+};
+
+#define SK_FRAME_STATISTICS_CONCAT_IMPL(a, b) a##b
+#define SK_FRAME_STATISTICS_CONCAT(a, b) SK_FRAME_STATISTICS_CONCAT_IMPL(a, b)
+#define SK_FRAME_STATISTICS_SCOPE(name)\
+    static const uint32_t SK_FRAME_STATISTICS_CONCAT(_sk_frame_statistics_metric_, __LINE__) = FrameStatistics::getMetric(name);\
+    FrameStatistics::Scope SK_FRAME_STATISTICS_CONCAT(_sk_frame_statistics_scope_, __LINE__)(SK_FRAME_STATISTICS_CONCAT(_sk_frame_statistics_metric_, __LINE__))
\ No newline at end of file
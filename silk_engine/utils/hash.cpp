@@ -0,0 +1,84 @@
+#include "hash.h"
+
+namespace
+{
+    uint64_t read8(const uint8_t* data)
+    {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint64_t read4(const uint8_t* data)
+    {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    // 1 to 3 bytes, reads the first, middle and last byte
+    uint64_t read3(const uint8_t* data, size_t size)
+    {
+        return (uint64_t(data[0]) << 16) | (uint64_t(data[size >> 1]) << 8) | data[size - 1];
+    }
+
+    void multiply(uint64_t& a, uint64_t& b)
+    {
+#ifdef _MSC_VER
+        a = _umul128(a, b, &b);
+#else
+        unsigned __int128 product = (unsigned __int128)a * b;
+        a = uint64_t(product);
+        b = uint64_t(product >> 64);
+#endif
+    }
+}
+
+uint64_t Hash::bytes(const void* data, size_t size, uint64_t seed)
+{
+    const uint8_t* p = scast<const uint8_t*>(data);
+    seed ^= mix(seed ^ SECRET[0], SECRET[1]);
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            a = (read4(p) << 32) | read4(p + ((size >> 3) << 2));
+            b = (read4(p + size - 4) << 32) | read4(p + size - 4 - ((size >> 3) << 2));
+        }
+        else if (size > 0)
+            a = read3(p, size);
+    }
+    else
+    {
+        size_t remaining = size;
+        if (remaining > 48)
+        {
+            // Three independent lanes, so the multiplies overlap
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do
+            {
+                seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+                seed1 = mix(read8(p + 16) ^ SECRET[2], read8(p + 24) ^ seed1);
+                seed2 = mix(read8(p + 32) ^ SECRET[3], read8(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (remaining > 16)
+        {
+            seed = mix(read8(p) ^ SECRET[1], read8(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read8(p + remaining - 16);
+        b = read8(p + remaining - 8);
+    }
+    a ^= SECRET[1];
+    b ^= seed;
+    multiply(a, b);
+    return mix(a ^ SECRET[0] ^ size, b ^ SECRET[1]);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+// wyhash: fast on the small keys engine caches use, and every output bit depends on every input bit,
+// so the low bits alone can index power of two tables
+class Hash
+{
+public:
+    static uint64_t bytes(const void* data, size_t size, uint64_t seed = 0);
+
+    // Hashes the object representation, T must not have padding
+    template<typename T>
+    static uint64_t value(const T& value, uint64_t seed = 0)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Hash: Value must be trivially copyable");
+        return bytes(&value, sizeof(T), seed);
+    }
+
+    template<typename T>
+    static uint64_t span(std::span<const T> values, uint64_t seed = 0)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Hash: Values must be trivially copyable");
+        return bytes(values.data(), values.size_bytes(), seed);
+    }
+
+    static uint64_t string(std::string_view string, uint64_t seed = 0) { return bytes(string.data(), string.size(), seed); }
+
+    // Order dependent, combine(combine(seed, a), b) != combine(combine(seed, b), a)
+    static uint64_t combine(uint64_t seed, uint64_t value) { return mix(seed ^ SECRET[0], value ^ SECRET[1]); }
+
+    // Folded 128 bit product
+    static uint64_t mix(uint64_t a, uint64_t b)
+    {
+#ifdef _MSC_VER
+        uint64_t high = 0;
+        uint64_t low = _umul128(a, b, &high);
+        return low ^ high;
+#else
+        unsigned __int128 product = (unsigned __int128)a * b;
+        return uint64_t(product) ^ uint64_t(product >> 64);
+#endif
+    }
+
+private:
+    static constexpr uint64_t SECRET[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+};
+
+// Default hash of HashMap and HashSet keys: strings by content, everything else by its bytes
+template<typename T>
+struct Hasher
+{
+    size_t operator()(const T& value) const
+    {
+        if constexpr (std::is_convertible_v<const T&, std::string_view>)
+            return Hash::string(value);
+        else
+            return Hash::value(value);
+    }
+};
\ No newline at end of file
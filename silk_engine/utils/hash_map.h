@@ -0,0 +1,277 @@
+#pragma once
+
+#include "hash.h"
+
+// Open addressing table with linear probing over one flat array, so lookups touch a few adjacent slots
+// instead of chasing node pointers. Every slot has a control byte (empty, or the top hash bit set plus 7 more
+// hash bits), compared before the key. Erase shifts later entries back instead of leaving tombstones.
+// Rehashing moves entries, so references and iterators are invalidated by any insert
+template<typename Key, typename Entry, typename KeyHash, typename KeyEqual>
+class HashTable
+{
+private:
+    static constexpr uint8_t EMPTY = 0;
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    template<bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const Entry*, Entry*>;
+        using reference = std::conditional_t<Const, const Entry&, Entry&>;
+        using Table = std::conditional_t<Const, const HashTable, HashTable>;
+
+    public:
+        Iterator() = default;
+        Iterator(Table* table, size_t index)
+            : table(table), index(index) { skipEmpty(); }
+        operator Iterator<true>() const { return Iterator<true>(table, index); }
+
+        reference operator*() const { return *table->entries[index]; }
+        pointer operator->() const { return &*table->entries[index]; }
+        Iterator& operator++() { ++index; skipEmpty(); return *this; }
+        Iterator operator++(int) { Iterator previous = *this; ++*this; return previous; }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+
+    private:
+        void skipEmpty()
+        {
+            while (index < table->controls.size() && table->controls[index] == EMPTY)
+                ++index;
+        }
+
+    private:
+        Table* table = nullptr;
+        size_t index = 0;
+
+        friend class HashTable;
+    };
+
+public:
+    using key_type = Key;
+    using value_type = Entry;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+public:
+    HashTable() = default;
+    HashTable(const HashTable& other) = default;
+    HashTable(HashTable&& other) noexcept
+        : controls(std::move(other.controls)), entries(std::move(other.entries)), count(std::exchange(other.count, 0)) {}
+    HashTable& operator=(HashTable other) noexcept
+    {
+        std::swap(controls, other.controls);
+        std::swap(entries, other.entries);
+        std::swap(count, other.count);
+        return *this;
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, controls.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, controls.size()); }
+
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+    size_t capacity() const { return controls.size(); }
+
+    void clear()
+    {
+        controls.clear();
+        entries.clear();
+        count = 0;
+    }
+
+    // Makes room for count entries without rehashing
+    void reserve(size_t count)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (count > getMaxLoad(capacity))
+            capacity *= 2;
+        if (capacity > controls.size())
+            rehash(capacity);
+    }
+
+    iterator find(const Key& key)
+    {
+        size_t index = findIndex(key);
+        return index == NOT_FOUND ? end() : iterator(this, index);
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        size_t index = findIndex(key);
+        return index == NOT_FOUND ? end() : const_iterator(this, index);
+    }
+
+    bool contains(const Key& key) const { return findIndex(key) != NOT_FOUND; }
+
+    bool erase(const Key& key)
+    {
+        size_t index = findIndex(key);
+        if (index == NOT_FOUND)
+            return false;
+        eraseIndex(index);
+        return true;
+    }
+
+    // Later entries may shift into the erased slot, so iterators aren't valid afterwards
+    void erase(const_iterator it) { eraseIndex(it.index); }
+
+protected:
+    static constexpr size_t NOT_FOUND = std::numeric_limits<size_t>::max();
+
+    static const Key& getKey(const Entry& entry)
+    {
+        if constexpr (std::is_same_v<Key, Entry>)
+            return entry;
+        else
+            return entry.first;
+    }
+
+    // Index of the entry with key, or of the empty slot it would go in
+    std::pair<size_t, bool> findSlot(const Key& key, size_t hash) const
+    {
+        uint8_t control = getControl(hash);
+        size_t mask = controls.size() - 1;
+        for (size_t index = getHome(hash, mask);; index = (index + 1) & mask)
+        {
+            if (controls[index] == EMPTY)
+                return { index, false };
+            if (controls[index] == control && KeyEqual{}(getKey(*entries[index]), key))
+                return { index, true };
+        }
+    }
+
+    // Returns the entry with key, constructed from args if it isn't there yet
+    template<typename... Args>
+    std::pair<iterator, bool> emplaceKey(const Key& key, Args&&... args)
+    {
+        if (count + 1 > getMaxLoad(controls.size()))
+            rehash(std::max(controls.size() * 2, MIN_CAPACITY));
+        size_t hash = KeyHash{}(key);
+        auto [index, found] = findSlot(key, hash);
+        if (found)
+            return { iterator(this, index), false };
+        entries[index].emplace(std::forward<Args>(args)...);
+        controls[index] = getControl(hash);
+        ++count;
+        return { iterator(this, index), true };
+    }
+
+private:
+    static size_t getMaxLoad(size_t capacity) { return capacity - capacity / 8; }
+    static uint8_t getControl(size_t hash) { return uint8_t(0x80 | (hash >> 57)); }
+    static size_t getHome(size_t hash, size_t mask) { return hash & mask; }
+
+    size_t findIndex(const Key& key) const
+    {
+        if (!count)
+            return NOT_FOUND;
+        auto [index, found] = findSlot(key, KeyHash{}(key));
+        return found ? index : NOT_FOUND;
+    }
+
+    void eraseIndex(size_t hole)
+    {
+        // Shift back every following entry of the probe run that isn't at or past its home already
+        size_t mask = controls.size() - 1;
+        for (size_t index = (hole + 1) & mask; controls[index] != EMPTY; index = (index + 1) & mask)
+        {
+            size_t home = getHome(KeyHash{}(getKey(*entries[index])), mask);
+            bool reachable = hole <= index ? (hole < home && home <= index) : (hole < home || home <= index);
+            if (reachable)
+                continue;
+            entries[hole].reset();
+            entries[hole].emplace(std::move(*entries[index]));
+            controls[hole] = controls[index];
+            hole = index;
+        }
+        entries[hole].reset();
+        controls[hole] = EMPTY;
+        --count;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::vector<uint8_t> old_controls = std::exchange(controls, std::vector<uint8_t>(capacity, EMPTY));
+        std::vector<std::optional<Entry>> old_entries = std::exchange(entries, std::vector<std::optional<Entry>>(capacity));
+        for (size_t i = 0; i < old_controls.size(); ++i)
+        {
+            if (old_controls[i] == EMPTY)
+                continue;
+            size_t hash = KeyHash{}(getKey(*old_entries[i]));
+            size_t index = findSlot(getKey(*old_entries[i]), hash).first;
+            entries[index].emplace(std::move(*old_entries[i]));
+            controls[index] = old_controls[i];
+        }
+    }
+
+private:
+    std::vector<uint8_t> controls;
+    std::vector<std::optional<Entry>> entries;
+    size_t count = 0;
+};
+
+template<typename Key, typename Value, typename KeyHash = Hasher<Key>, typename KeyEqual = std::equal_to<Key>>
+class HashMap : public HashTable<Key, std::pair<const Key, Value>, KeyHash, KeyEqual>
+{
+private:
+    using Base = HashTable<Key, std::pair<const Key, Value>, KeyHash, KeyEqual>;
+
+public:
+    using mapped_type = Value;
+    using typename Base::iterator;
+
+public:
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        return this->emplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args) { return try_emplace(key, std::forward<Args>(args)...); }
+
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value)
+    {
+        auto result = try_emplace(key, std::forward<V>(value));
+        if (!result.second)
+            result.first->second = std::forward<V>(value);
+        return result;
+    }
+
+    Value& operator[](const Key& key) { return try_emplace(key).first->second; }
+
+    Value& at(const Key& key)
+    {
+        auto it = this->find(key);
+        SK_ASSERT(it != this->end(), "HashMap: Key not found");
+        return it->second;
+    }
+
+    const Value& at(const Key& key) const
+    {
+        auto it = this->find(key);
+        SK_ASSERT(it != this->end(), "HashMap: Key not found");
+        return it->second;
+    }
+};
+
+template<typename Key, typename KeyHash = Hasher<Key>, typename KeyEqual = std::equal_to<Key>>
+class HashSet : public HashTable<Key, Key, KeyHash, KeyEqual>
+{
+private:
+    using Base = HashTable<Key, Key, KeyHash, KeyEqual>;
+
+public:
+    using typename Base::iterator;
+
+public:
+    std::pair<iterator, bool> insert(const Key& key) { return this->emplaceKey(key, key); }
+    std::pair<iterator, bool> emplace(const Key& key) { return insert(key); }
+};
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "linear_arena.h"
+
+LinearArena::LinearArena(size_t block_size)
+    : block_size(block_size)
+{
+}
+
+LinearArena::~LinearArena()
+{
+    for (const auto& block : blocks)
+        ::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+}
+
+void* LinearArena::allocate(size_t size, size_t alignment)
+{
+    SK_VERIFY(std::has_single_bit(alignment), "Alignment must be a power of 2");
+    size = std::max(size, size_t(1));
+    while (current < blocks.size())
+    {
+        const Block& block = blocks[current];
+        uintptr_t address = rcast<uintptr_t>(block.data) + offset;
+        size_t aligned_offset = offset + (((address + alignment - 1) & ~(alignment - 1)) - address);
+        if (aligned_offset + size <= block.size)
+        {
+            offset = aligned_offset + size;
+            used += size;
+            return block.data + aligned_offset;
+        }
+        ++current;
+        offset = 0;
+    }
+    addBlock(size + alignment);
+    return allocate(size, alignment);
+}
+
+void LinearArena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        // Frame didn't fit, replace chained blocks with one that holds all of them
+        for (const auto& block : blocks)
+            ::operator delete(block.data, std::align_val_t(alignof(std::max_align_t)));
+        blocks.clear();
+        size_t size = capacity;
+        capacity = 0;
+        addBlock(size);
+    }
+    current = 0;
+    offset = 0;
+    used = 0;
+}
+
+void LinearArena::addBlock(size_t min_size)
+{
+    size_t size = std::max({ block_size, min_size, capacity });
+    blocks.emplace_back(Block{ scast<std::byte*>(::operator new(size, std::align_val_t(alignof(std::max_align_t)))), size });
+    capacity += size;
+    current = blocks.size() - 1;
+    offset = 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+// Bump allocator for short lived data: allocating is a pointer increment, nothing is freed individually,
+// reset() releases everything at once. Destructors of objects created in it are never called.
+// When a frame outgrows the arena, extra blocks get chained and on reset they are merged into a single block,
+// so after a few frames the arena stops allocating from the heap.
+class LinearArena : NoCopy
+{
+private:
+    struct Block
+    {
+        std::byte* data = nullptr;
+        size_t size = 0;
+    };
+
+public:
+    LinearArena(size_t block_size = 64 * 1024);
+    ~LinearArena();
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+    void reset();
+
+    template<typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    std::span<T> allocateArray(size_t count)
+    {
+        T* data = scast<T*>(allocate(count * sizeof(T), alignof(T)));
+        std::uninitialized_value_construct_n(data, count);
+        return { data, count };
+    }
+
+    size_t getUsed() const { return used; }
+    size_t getCapacity() const { return capacity; }
+
+private:
+    void addBlock(size_t min_size);
+
+private:
+    size_t block_size = 0;
+    std::vector<Block> blocks = {};
+    size_t current = 0;
+    size_t offset = 0;
+    size_t used = 0;
+    size_t capacity = 0;
+};
+
+// STL allocator over a LinearArena, deallocate is a no-op so containers should be short lived too
+template<typename T>
+class ArenaAllocator
+{
+    template<typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+public:
+    ArenaAllocator(LinearArena& arena)
+        : arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other)
+        : arena(other.arena) {}
+
+    T* allocate(size_t count) { return scast<T*>(arena->allocate(count * sizeof(T), alignof(T))); }
+    void deallocate(T*, size_t) {}
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+
+private:
+    LinearArena* arena = nullptr;
+};
+
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "memory_tracker.h"
+
+namespace
+{
+    // Stored right before every block the tracker hands out
+    struct alignas(16) Header
+    {
+        size_t size = 0;
+        uint32_t offset = 0; // From the start of the malloc'd block
+        MemoryTracker::Tag tag = MemoryTracker::Tag::GENERAL;
+    };
+
+    Header& getHeader(void* data)
+    {
+        return *(rcast<Header*>(data) - 1);
+    }
+}
+
+// Constant initialized, operator new may run before any dynamic initializer
+constinit std::array<std::array<MemoryTracker::Counter, size_t(MemoryTracker::Tag::COUNT)>, size_t(MemoryTracker::Domain::COUNT)> MemoryTracker::counters = {};
+
+void MemoryTracker::update()
+{
+    for (size_t domain = 0; domain < size_t(Domain::COUNT); ++domain)
+    {
+        for (size_t tag = 0; tag < size_t(Tag::COUNT); ++tag)
+        {
+            Counter& counter = counters[domain][tag];
+            size_t allocations = counter.allocations.load(std::memory_order_relaxed);
+            size_t allocated = counter.allocated.load(std::memory_order_relaxed);
+            counter.frame_allocations = allocations - counter.last_allocations;
+            counter.frame_bytes = allocated - counter.last_allocated;
+            counter.last_allocations = allocations;
+            counter.last_allocated = allocated;
+
+            size_t live = counter.live.load(std::memory_order_relaxed);
+            bool over_budget = counter.budget && live > counter.budget;
+            if (over_budget && !counter.over_budget)
+                SK_WARN("Memory: {} {} memory is over budget, {} / {}", getName(Tag(tag)), domain == size_t(Domain::HOST) ? "host" : "device", std::Bytes(live), std::Bytes(counter.budget));
+            counter.over_budget = over_budget;
+        }
+    }
+}
+
+void MemoryTracker::report()
+{
+    for (size_t domain = 0; domain < size_t(Domain::COUNT); ++domain)
+    {
+        SK_INFO("Memory: {}", domain == size_t(Domain::HOST) ? "Host" : "Device");
+        for (size_t tag = 0; tag < size_t(Tag::COUNT); ++tag)
+        {
+            Usage usage = getUsage(Tag(tag), Domain(domain));
+            if (!usage.peak)
+                continue;
+            SK_INFO("  {}: {} live ({} allocations), {} peak, {} allocations ({}) last frame{}", getName(Tag(tag)), std::Bytes(usage.live), usage.allocations, std::Bytes(usage.peak),
+                usage.frame_allocations, std::Bytes(usage.frame_bytes), usage.budget ? std::format(", {} budget", std::Bytes(usage.budget)) : "");
+        }
+    }
+}
+
+void MemoryTracker::setBudget(Tag tag, Domain domain, size_t bytes)
+{
+    getCounter(tag, domain).budget = bytes;
+}
+
+MemoryTracker::Usage MemoryTracker::getUsage(Tag tag, Domain domain)
+{
+    const Counter& counter = getCounter(tag, domain);
+    Usage usage{};
+    usage.live = counter.live.load(std::memory_order_relaxed);
+    usage.peak = counter.peak.load(std::memory_order_relaxed);
+    usage.allocations = counter.allocations.load(std::memory_order_relaxed) - counter.frees.load(std::memory_order_relaxed);
+    usage.frame_allocations = counter.frame_allocations;
+    usage.frame_bytes = counter.frame_bytes;
+    usage.budget = counter.budget;
+    return usage;
+}
+
+const char* MemoryTracker::getName(Tag tag)
+{
+    switch (tag)
+    {
+    case Tag::GENERAL: return "General";
+    case Tag::WORLD: return "World";
+    case Tag::DEBUG_RENDERER: return "DebugRenderer";
+    case Tag::IMAGES: return "Images";
+    case Tag::BUFFERS: return "Buffers";
+    case Tag::VULKAN: return "Vulkan";
+    }
+    return "Unknown";
+}
+
+void* MemoryTracker::allocate(size_t size, size_t alignment, Tag tag)
+{
+    alignment = std::max(alignment, alignof(Header));
+    size_t padding = sizeof(Header) + (alignment > alignof(Header) ? alignment : 0);
+    uint8_t* block = scast<uint8_t*>(std::malloc(size + padding));
+    if (!block)
+        return nullptr;
+    uint8_t* data = rcast<uint8_t*>((uintptr_t(block) + sizeof(Header) + alignment - 1) & ~uintptr_t(alignment - 1));
+    getHeader(data) = Header{ size, uint32_t(data - block), tag };
+    recordAllocation(tag, Domain::HOST, size);
+    return data;
+}
+
+void* MemoryTracker::reallocate(void* data, size_t size, size_t alignment, Tag tag)
+{
+    if (!data)
+        return allocate(size, alignment, tag);
+    if (!size)
+    {
+        free(data);
+        return nullptr;
+    }
+    void* new_data = allocate(size, alignment, tag);
+    if (!new_data)
+        return nullptr;
+    memcpy(new_data, data, std::min(size, getHeader(data).size));
+    free(data);
+    return new_data;
+}
+
+void MemoryTracker::free(void* data)
+{
+    if (!data)
+        return;
+    const Header& header = getHeader(data);
+    recordFree(header.tag, Domain::HOST, header.size);
+    std::free(scast<uint8_t*>(data) - header.offset);
+}
+
+void MemoryTracker::recordAllocation(Tag tag, Domain domain, size_t size)
+{
+    Counter& counter = getCounter(tag, domain);
+    size_t live = counter.live.fetch_add(size, std::memory_order_relaxed) + size;
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.allocated.fetch_add(size, std::memory_order_relaxed);
+    size_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (live > peak && !counter.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed));
+}
+
+void MemoryTracker::recordFree(Tag tag, Domain domain, size_t size)
+{
+    Counter& counter = getCounter(tag, domain);
+    counter.live.fetch_sub(size, std::memory_order_relaxed);
+    counter.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+const VkAllocationCallbacks* MemoryTracker::getVulkanCallbacks()
+{
+#ifdef SK_ENABLE_MEMORY_TRACKING
+    static const VkAllocationCallbacks callbacks = []
+    {
+        VkAllocationCallbacks callbacks{};
+        callbacks.pfnAllocation = [](void*, size_t size, size_t alignment, VkSystemAllocationScope) { return allocate(size, alignment, Tag::VULKAN); };
+        callbacks.pfnReallocation = [](void*, void* original, size_t size, size_t alignment, VkSystemAllocationScope) { return reallocate(original, size, alignment, Tag::VULKAN); };
+        callbacks.pfnFree = [](void*, void* memory) { free(memory); };
+        return callbacks;
+    }();
+    return &callbacks;
+#else
+    return nullptr;
+#endif
+}
+
+#ifdef SK_ENABLE_MEMORY_TRACKING
+void* operator new(size_t size)
+{
+    if (void* data = MemoryTracker::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, MemoryTracker::getTag()))
+        return data;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    if (void* data = MemoryTracker::allocate(size, size_t(alignment), MemoryTracker::getTag()))
+        return data;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, MemoryTracker::getTag()); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, MemoryTracker::getTag()); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, size_t(alignment), MemoryTracker::getTag()); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, size_t(alignment), MemoryTracker::getTag()); }
+
+void operator delete(void* data) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data) noexcept { MemoryTracker::free(data); }
+void operator delete(void* data, size_t) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data, size_t) noexcept { MemoryTracker::free(data); }
+void operator delete(void* data, std::align_val_t) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data, std::align_val_t) noexcept { MemoryTracker::free(data); }
+void operator delete(void* data, size_t, std::align_val_t) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data, size_t, std::align_val_t) noexcept { MemoryTracker::free(data); }
+void operator delete(void* data, const std::nothrow_t&) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data, const std::nothrow_t&) noexcept { MemoryTracker::free(data); }
+void operator delete(void* data, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::free(data); }
+void operator delete[](void* data, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::free(data); }
+#endif
\ No newline at end of file
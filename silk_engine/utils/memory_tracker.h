@@ -0,0 +1,94 @@
+#pragma once
+
+// Tracks live and peak memory per subsystem tag, for host memory (every operator new and Vulkan's host allocations)
+// and device memory (VMA allocations). Allocations take the calling thread's current tag, set with Scope, and
+// remember it so frees are attributed correctly. update() turns counters into per frame rates and warns once
+// whenever a tag goes over its budget
+class MemoryTracker
+{
+public:
+    enum class Tag : uint8_t
+    {
+        GENERAL,
+        WORLD,
+        DEBUG_RENDERER,
+        IMAGES, // Device images without a more specific tag
+        BUFFERS, // Device buffers without a more specific tag
+        VULKAN, // Host memory of the Vulkan implementation
+        COUNT
+    };
+
+    enum class Domain : uint8_t
+    {
+        HOST,
+        DEVICE,
+        COUNT
+    };
+
+    struct Usage
+    {
+        size_t live = 0;
+        size_t peak = 0;
+        size_t allocations = 0; // Live allocations
+        size_t frame_allocations = 0; // Allocations during the last frame
+        size_t frame_bytes = 0; // Bytes allocated during the last frame
+        size_t budget = 0; // 0 when unlimited
+    };
+
+    // Sets the calling thread's tag until destroyed
+    class Scope : NoCopyNoMove
+    {
+    public:
+        Scope(Tag tag)
+            : previous(MemoryTracker::getTag()) { MemoryTracker::setTag(tag); }
+        ~Scope() { MemoryTracker::setTag(previous); }
+
+    private:
+        Tag previous = Tag::GENERAL;
+    };
+
+public:
+    // Call once per frame
+    static void update();
+    // Logs usage of every tag
+    static void report();
+
+    static void setBudget(Tag tag, Domain domain, size_t bytes);
+    static Usage getUsage(Tag tag, Domain domain);
+    static const char* getName(Tag tag);
+
+    static Tag getTag() { return current_tag; }
+    static void setTag(Tag tag) { current_tag = tag; }
+
+    static void* allocate(size_t size, size_t alignment, Tag tag);
+    static void* reallocate(void* data, size_t size, size_t alignment, Tag tag);
+    static void free(void* data);
+    // For memory that isn't allocated by the tracker itself, like VMA allocations
+    static void recordAllocation(Tag tag, Domain domain, size_t size);
+    static void recordFree(Tag tag, Domain domain, size_t size);
+
+    // Routes the Vulkan implementation's host allocations through the tracker
+    static const VkAllocationCallbacks* getVulkanCallbacks();
+
+private:
+    struct Counter
+    {
+        std::atomic<size_t> live = 0;
+        std::atomic<size_t> peak = 0;
+        std::atomic<size_t> allocations = 0; // Total since start
+        std::atomic<size_t> frees = 0;
+        std::atomic<size_t> allocated = 0; // Total bytes since start
+        size_t frame_allocations = 0;
+        size_t frame_bytes = 0;
+        size_t last_allocations = 0;
+        size_t last_allocated = 0;
+        size_t budget = 0;
+        bool over_budget = false;
+    };
+
+    static Counter& getCounter(Tag tag, Domain domain) { return counters[size_t(domain)][size_t(tag)]; }
+
+private:
+    static std::array<std::array<Counter, size_t(Tag::COUNT)>, size_t(Domain::COUNT)> counters;
+    static inline thread_local Tag current_tag = Tag::GENERAL;
+};
\ No newline at end of file
@@ -0,0 +1,135 @@
+#pragma once
+
+// Index and generation of an object in an ObjectPool packed in one integer.
+// 64 bit handles use 32 bits for each, 32 bit handles use 20 index bits (~1M objects) and 12 generation bits
+template<typename T, std::unsigned_integral Id = uint64_t>
+class PoolHandle
+{
+public:
+    static constexpr size_t INDEX_BITS = sizeof(Id) >= sizeof(uint64_t) ? 32 : 20;
+    static constexpr size_t GENERATION_BITS = sizeof(Id) * 8 - INDEX_BITS;
+    static constexpr Id INDEX_MASK = (Id(1) << INDEX_BITS) - 1;
+    static constexpr Id GENERATION_MASK = (Id(1) << GENERATION_BITS) - 1;
+    static constexpr Id NONE = std::numeric_limits<Id>::max();
+
+public:
+    PoolHandle() = default;
+    PoolHandle(Id index, Id generation)
+        : id((generation << INDEX_BITS) | index) {}
+
+    Id getIndex() const { return id & INDEX_MASK; }
+    Id getGeneration() const { return id >> INDEX_BITS; }
+    Id getId() const { return id; }
+
+    bool isValid() const { return id != NONE; }
+    explicit operator bool() const { return isValid(); }
+    bool operator==(const PoolHandle& other) const = default;
+
+private:
+    Id id = NONE;
+};
+
+// Stores objects in fixed size blocks, so pointers stay stable and objects stay close in memory.
+// Create and destroy are O(1) through a free list of slots, every slot has a generation that's bumped on destroy,
+// so handles to destroyed objects are detected instead of pointing at whatever reused the slot. Not thread safe
+template<typename T, std::unsigned_integral Id = uint64_t, size_t BLOCK_SIZE = 256>
+class ObjectPool : NoCopy
+{
+public:
+    using Handle = PoolHandle<T, Id>;
+
+private:
+    struct Slot
+    {
+        alignas(T) std::byte storage[sizeof(T)];
+        Id generation = 0;
+        Id next_free = Handle::NONE;
+        bool alive = false;
+
+        T* get() { return std::launder(rcast<T*>(storage)); }
+        const T* get() const { return std::launder(rcast<const T*>(storage)); }
+    };
+
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+
+    template<typename... Args>
+    Handle create(Args&&... args)
+    {
+        Id index = free_head;
+        if (index == Handle::NONE)
+        {
+            index = slot_count++;
+            SK_ASSERT(index < Handle::INDEX_MASK, "Object pool handle index overflow");
+            if (index / BLOCK_SIZE >= blocks.size())
+                blocks.emplace_back(makeUnique<Slot[]>(BLOCK_SIZE));
+        }
+        Slot& slot = getSlot(index);
+        free_head = slot.next_free;
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        ++count;
+        return Handle(index, slot.generation);
+    }
+
+    void destroy(Handle handle)
+    {
+        Slot* slot = findSlot(handle);
+        if (!slot)
+            return;
+        slot->get()->~T();
+        slot->alive = false;
+        slot->generation = (slot->generation + 1) & Handle::GENERATION_MASK;
+        slot->next_free = free_head;
+        free_head = handle.getIndex();
+        --count;
+    }
+
+    // @return nullptr if handle is stale
+    T* get(Handle handle)
+    {
+        Slot* slot = findSlot(handle);
+        return slot ? slot->get() : nullptr;
+    }
+    const T* get(Handle handle) const { return ccast<ObjectPool*>(this)->get(handle); }
+    bool contains(Handle handle) const { return ccast<ObjectPool*>(this)->findSlot(handle); }
+
+    // Calls function(handle, object) for every alive object in memory order
+    template<typename Fn>
+    void forEach(Fn&& function)
+    {
+        for (Id index = 0; index < slot_count; ++index)
+        {
+            Slot& slot = getSlot(index);
+            if (slot.alive)
+                function(Handle(index, slot.generation), *slot.get());
+        }
+    }
+
+    void clear()
+    {
+        forEach([this](Handle handle, T&) { destroy(handle); });
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return !count; }
+    size_t getCapacity() const { return blocks.size() * BLOCK_SIZE; }
+
+private:
+    Slot& getSlot(Id index) { return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE]; }
+
+    Slot* findSlot(Handle handle)
+    {
+        if (!handle || handle.getIndex() >= slot_count)
+            return nullptr;
+        Slot& slot = getSlot(handle.getIndex());
+        return (slot.alive && slot.generation == handle.getGeneration()) ? &slot : nullptr;
+    }
+
+private:
+    std::vector<unique<Slot[]>> blocks = {};
+    Id slot_count = 0;
+    Id free_head = Handle::NONE;
+    size_t count = 0;
+};
\ No newline at end of file
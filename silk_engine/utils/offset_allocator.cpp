@@ -0,0 +1,229 @@
+#include "offset_allocator.h"
+
+OffsetAllocator::OffsetAllocator(size_t size)
+    : capacity(size)
+{
+    reset();
+}
+
+OffsetAllocator::Range OffsetAllocator::allocate(size_t size, size_t alignment)
+{
+    SK_VERIFY(std::has_single_bit(alignment), "Alignment must be a power of 2");
+    size = std::max(size, size_t(1));
+
+    // Any range from the found bin holds size even at the worst alignment
+    size_t search_size = size + alignment - 1;
+    uint32_t node = NONE;
+    if (uint32_t bin = findBin(search_size); bin != NONE)
+        node = bin_heads[bin];
+    else if (uint32_t round_down_bin = getBinRoundDown(search_size); round_down_bin < BINS && bin_heads[round_down_bin] != NONE)
+    {
+        // Rounding up skipped the bin the size itself falls in, which can still hold a big enough range (e.g. the whole capacity).
+        // Only its head is checked, walking the bin would make a failing allocation linear in the free ranges
+        if (nodes[bin_heads[round_down_bin]].size >= search_size)
+            node = bin_heads[round_down_bin];
+    }
+    if (node == NONE)
+        return {};
+    removeFree(node);
+
+    size_t aligned_offset = (nodes[node].offset + alignment - 1) & ~(alignment - 1);
+    if (size_t padding = aligned_offset - nodes[node].offset)
+    {
+        uint32_t head = createNode(nodes[node].offset, padding);
+        nodes[head].neighbor_previous = nodes[node].neighbor_previous;
+        nodes[head].neighbor_next = node;
+        if (nodes[head].neighbor_previous != NONE)
+            nodes[nodes[head].neighbor_previous].neighbor_next = head;
+        nodes[node].neighbor_previous = head;
+        nodes[node].offset = aligned_offset;
+        nodes[node].size -= padding;
+        insertFree(head);
+    }
+    if (size_t remainder = nodes[node].size - size)
+    {
+        uint32_t tail = createNode(aligned_offset + size, remainder);
+        nodes[tail].neighbor_previous = node;
+        nodes[tail].neighbor_next = nodes[node].neighbor_next;
+        if (nodes[tail].neighbor_next != NONE)
+            nodes[nodes[tail].neighbor_next].neighbor_previous = tail;
+        nodes[node].neighbor_next = tail;
+        nodes[node].size = size;
+        insertFree(tail);
+    }
+
+    nodes[node].used = true;
+    ++allocations;
+    return { aligned_offset, node };
+}
+
+void OffsetAllocator::free(Range range)
+{
+    if (!range)
+        return;
+    uint32_t node = range.node;
+    SK_ASSERT(node < nodes.size() && nodes[node].used, "Freeing an offset allocator range that isn't allocated");
+    nodes[node].used = false;
+    --allocations;
+
+    uint32_t previous = nodes[node].neighbor_previous;
+    if (previous != NONE && !nodes[previous].used)
+    {
+        removeFree(previous);
+        nodes[node].offset = nodes[previous].offset;
+        nodes[node].size += nodes[previous].size;
+        nodes[node].neighbor_previous = nodes[previous].neighbor_previous;
+        if (nodes[node].neighbor_previous != NONE)
+            nodes[nodes[node].neighbor_previous].neighbor_next = node;
+        releaseNode(previous);
+    }
+
+    uint32_t next = nodes[node].neighbor_next;
+    if (next != NONE && !nodes[next].used)
+    {
+        removeFree(next);
+        nodes[node].size += nodes[next].size;
+        nodes[node].neighbor_next = nodes[next].neighbor_next;
+        if (nodes[node].neighbor_next != NONE)
+            nodes[nodes[node].neighbor_next].neighbor_previous = node;
+        releaseNode(next);
+    }
+
+    insertFree(node);
+}
+
+void OffsetAllocator::reset()
+{
+    nodes.clear();
+    unused_nodes.clear();
+    used_top_bins = 0;
+    used_leaf_bins.fill(0);
+    bin_heads.fill(NONE);
+    free_size = 0;
+    free_regions = 0;
+    allocations = 0;
+    if (capacity)
+        insertFree(createNode(0, capacity));
+}
+
+OffsetAllocator::Statistics OffsetAllocator::getStatistics() const
+{
+    Statistics statistics{};
+    statistics.free = free_size;
+    statistics.free_regions = free_regions;
+    statistics.allocations = allocations;
+    if (used_top_bins)
+    {
+        // Sizes in a bin only share the rounded down size, so the exact largest one has to be searched for
+        uint32_t top = std::bit_width(used_top_bins) - 1;
+        uint32_t leaf = std::bit_width(used_leaf_bins[top]) - 1;
+        for (uint32_t node = bin_heads[top * LEAF_BINS + leaf]; node != NONE; node = nodes[node].bin_next)
+            statistics.largest_free = std::max(statistics.largest_free, nodes[node].size);
+    }
+    return statistics;
+}
+
+uint32_t OffsetAllocator::createNode(size_t offset, size_t size)
+{
+    uint32_t node = 0;
+    if (unused_nodes.empty())
+    {
+        node = nodes.size();
+        nodes.emplace_back();
+    }
+    else
+    {
+        node = unused_nodes.back();
+        unused_nodes.pop_back();
+    }
+    nodes[node] = Node{ .offset = offset, .size = size };
+    return node;
+}
+
+void OffsetAllocator::releaseNode(uint32_t node)
+{
+    unused_nodes.emplace_back(node);
+}
+
+void OffsetAllocator::insertFree(uint32_t node)
+{
+    // Rounded down, so every range in a bin is at least the bin's size
+    uint32_t bin = getBinRoundDown(nodes[node].size);
+    uint32_t top = bin / LEAF_BINS;
+    uint32_t leaf = bin % LEAF_BINS;
+    nodes[node].bin_previous = NONE;
+    nodes[node].bin_next = bin_heads[bin];
+    if (bin_heads[bin] != NONE)
+        nodes[bin_heads[bin]].bin_previous = node;
+    bin_heads[bin] = node;
+    used_top_bins |= uint64_t(1) << top;
+    used_leaf_bins[top] |= 1 << leaf;
+    free_size += nodes[node].size;
+    ++free_regions;
+}
+
+void OffsetAllocator::removeFree(uint32_t node)
+{
+    const Node& removed = nodes[node];
+    if (removed.bin_previous != NONE)
+        nodes[removed.bin_previous].bin_next = removed.bin_next;
+    else
+    {
+        uint32_t bin = getBinRoundDown(removed.size);
+        bin_heads[bin] = removed.bin_next;
+        if (removed.bin_next == NONE)
+        {
+            uint32_t top = bin / LEAF_BINS;
+            used_leaf_bins[top] &= ~(1 << (bin % LEAF_BINS));
+            if (!used_leaf_bins[top])
+                used_top_bins &= ~(uint64_t(1) << top);
+        }
+    }
+    if (removed.bin_next != NONE)
+        nodes[removed.bin_next].bin_previous = removed.bin_previous;
+    free_size -= removed.size;
+    --free_regions;
+}
+
+uint32_t OffsetAllocator::findBin(size_t size) const
+{
+    // Rounded up, so any range in the found bin fits
+    uint32_t bin = getBinRoundUp(size);
+    if (bin >= BINS)
+        return NONE;
+    uint32_t top = bin / LEAF_BINS;
+    uint32_t leaf = bin % LEAF_BINS;
+
+    if (uint32_t leaves = used_leaf_bins[top] & (0xFF << leaf))
+        return top * LEAF_BINS + std::countr_zero(leaves);
+
+    uint64_t tops = top + 1 < TOP_BINS ? used_top_bins & (~uint64_t(0) << (top + 1)) : 0;
+    if (!tops)
+        return NONE;
+    top = std::countr_zero(tops);
+    return top * LEAF_BINS + std::countr_zero(used_leaf_bins[top]);
+}
+
+uint32_t OffsetAllocator::getBinRoundUp(size_t size)
+{
+    // Sizes below LEAF_BINS map to themselves, above that the exponent is the position of the highest bit
+    // and the mantissa the MANTISSA_BITS below it, adding instead of or-ing lets a mantissa overflow carry into the exponent
+    if (size < LEAF_BINS)
+        return size;
+    uint32_t mantissa_start = std::bit_width(size) - 1 - MANTISSA_BITS;
+    uint32_t exponent = mantissa_start + 1;
+    uint32_t mantissa = (size >> mantissa_start) & (LEAF_BINS - 1);
+    if (size & ((size_t(1) << mantissa_start) - 1))
+        ++mantissa;
+    return exponent * LEAF_BINS + mantissa;
+}
+
+uint32_t OffsetAllocator::getBinRoundDown(size_t size)
+{
+    if (size < LEAF_BINS)
+        return size;
+    uint32_t mantissa_start = std::bit_width(size) - 1 - MANTISSA_BITS;
+    uint32_t exponent = mantissa_start + 1;
+    uint32_t mantissa = (size >> mantissa_start) & (LEAF_BINS - 1);
+    return exponent * LEAF_BINS + mantissa;
+}
\ No newline at end of file
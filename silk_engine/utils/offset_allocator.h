@@ -0,0 +1,80 @@
+#pragma once
+
+// Suballocates ranges of an external resource (e.g. a big GPU buffer), it only hands out offsets and never touches memory.
+// Free ranges are kept in TLSF style two level bins: sizes are rounded to a small float (6 exponent, 3 mantissa bits),
+// a bitmask per level finds the first non empty bin that fits in O(1), and freed ranges merge with their free neighbors in O(1)
+class OffsetAllocator : NoCopy
+{
+public:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    struct Range
+    {
+        size_t offset = 0;
+        uint32_t node = NONE;
+
+        bool isValid() const { return node != NONE; }
+        explicit operator bool() const { return isValid(); }
+    };
+
+    struct Statistics
+    {
+        size_t free = 0;
+        size_t largest_free = 0;
+        size_t free_regions = 0;
+        size_t allocations = 0;
+
+        // 0 when all free space is one region, approaches 1 as it's split into many small ones
+        float getFragmentation() const { return free ? 1.0f - float(largest_free) / float(free) : 0.0f; }
+    };
+
+private:
+    static constexpr uint32_t MANTISSA_BITS = 3;
+    static constexpr uint32_t LEAF_BINS = 1 << MANTISSA_BITS;
+    static constexpr uint32_t TOP_BINS = 64;
+    static constexpr uint32_t BINS = TOP_BINS * LEAF_BINS;
+
+    struct Node
+    {
+        size_t offset = 0;
+        size_t size = 0;
+        uint32_t bin_previous = NONE;
+        uint32_t bin_next = NONE;
+        uint32_t neighbor_previous = NONE;
+        uint32_t neighbor_next = NONE;
+        bool used = false;
+    };
+
+public:
+    OffsetAllocator(size_t size);
+
+    // @return invalid range if no free range fits, ranges under one bin step (an 8th) larger than needed are only found at their bin head
+    Range allocate(size_t size, size_t alignment = 1);
+    void free(Range range);
+    void reset();
+
+    size_t getSize(Range range) const { return nodes[range.node].size; }
+    size_t getCapacity() const { return capacity; }
+    Statistics getStatistics() const;
+
+private:
+    uint32_t createNode(size_t offset, size_t size);
+    void releaseNode(uint32_t node);
+    void insertFree(uint32_t node);
+    void removeFree(uint32_t node);
+    uint32_t findBin(size_t size) const;
+
+    static uint32_t getBinRoundUp(size_t size);
+    static uint32_t getBinRoundDown(size_t size);
+
+private:
+    size_t capacity = 0;
+    std::vector<Node> nodes = {};
+    std::vector<uint32_t> unused_nodes = {};
+    uint64_t used_top_bins = 0;
+    std::array<uint8_t, TOP_BINS> used_leaf_bins = {};
+    std::array<uint32_t, BINS> bin_heads = {};
+    size_t free_size = 0;
+    size_t free_regions = 0;
+    size_t allocations = 0;
+};
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "profiler.h"
+#include "concurrent_queue.h"
+#include "silk_engine/io/file.h"
+#include "string.h"
+
+struct Profiler::ThreadBuffer
+{
+    ThreadBuffer(uint32_t thread)
+        : thread(thread), name(std::format("Thread {}", thread)) {}
+
+    unique<SPSCQueue<Event>> events = nullptr; // Allocated on first record, threads that only get named stay cheap
+    uint32_t thread = 0;
+    std::string name;
+};
+
+void Profiler::start()
+{
+    clear();
+    capturing = true;
+}
+
+void Profiler::stop()
+{
+    capturing = false;
+    update();
+}
+
+void Profiler::update()
+{
+    std::scoped_lock lock(mutex);
+    std::array<Event, 256> batch;
+    for (const auto& buffer : buffers)
+    {
+        if (!buffer->events)
+            continue;
+        while (size_t count = buffer->events->tryPop(std::span<Event>(batch)))
+            events.insert(events.end(), batch.begin(), batch.begin() + count);
+    }
+}
+
+void Profiler::save(const fs::path& file)
+{
+    update();
+
+    std::string json = "{\"traceEvents\":[\n";
+    {
+        std::scoped_lock lock(mutex);
+        for (const auto& buffer : buffers)
+            json += std::format("{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}},\n", buffer->thread, String::escapeJson(buffer->name));
+        for (const auto& event : events)
+            json += std::format("{{\"ph\":\"X\",\"name\":\"{}\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}},\n", String::escapeJson(event.name), event.thread, event.start * 1e-3, (event.end - event.start) * 1e-3);
+    }
+    if (json.ends_with(",\n"))
+        json.resize(json.size() - 2);
+    json += "\n],\"displayTimeUnit\":\"ms\"}";
+
+    if (!File::directory(file).empty() && !fs::exists(File::directory(file)))
+        fs::create_directories(File::directory(file));
+    File::write(file, json.data(), json.size());
+    SK_INFO("Profile saved at {} ({} events, {} dropped)", file, events.size(), getDroppedEvents());
+}
+
+void Profiler::clear()
+{
+    update();
+    std::scoped_lock lock(mutex);
+    events.clear();
+    dropped_events = 0;
+}
+
+void Profiler::setThreadName(std::string_view name)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::scoped_lock lock(mutex);
+    buffer.name = name;
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadBuffer& buffer = getThreadBuffer();
+    if (!buffer.events)
+    {
+        std::scoped_lock lock(mutex);
+        buffer.events = makeUnique<SPSCQueue<Event>>(THREAD_BUFFER_CAPACITY);
+    }
+    if (!buffer.events->tryPush(Event{ name, start, end, buffer.thread }))
+        ++dropped_events;
+}
+
+uint32_t Profiler::addTrack(std::string_view name)
+{
+    std::scoped_lock lock(mutex);
+    ThreadBuffer& track = *buffers.emplace_back(makeShared<ThreadBuffer>(uint32_t(buffers.size())));
+    track.name = name;
+    return track.thread;
+}
+
+void Profiler::record(uint32_t track, const char* name, uint64_t start, uint64_t end)
+{
+    if (!isCapturing())
+        return;
+    std::scoped_lock lock(mutex);
+    events.emplace_back(Event{ name, start, end, track });
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer)
+    {
+        std::scoped_lock lock(mutex);
+        buffer = buffers.emplace_back(makeShared<ThreadBuffer>(uint32_t(buffers.size()))).get();
+    }
+    return *buffer;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+// Records scopes on every thread while a capture is running and saves them as a Chrome trace
+// (open in chrome://tracing or ui.perfetto.dev), nested scopes show up as a hierarchy per thread.
+// Each thread writes into its own lock-free ring buffer, which update() drains once per frame,
+// while no capture is running a scope costs one relaxed load
+class Profiler
+{
+public:
+    struct Event
+    {
+        const char* name = nullptr; // Must outlive the capture, e.g. a string literal
+        uint64_t start = 0; // Nanoseconds since profiler start
+        uint64_t end = 0;
+        uint32_t thread = 0;
+    };
+
+    class Scope : NoCopyNoMove
+    {
+    public:
+        Scope(const char* name)
+            : name(Profiler::isCapturing() ? name : nullptr), start(this->name ? Profiler::getTime() : 0) {}
+        ~Scope()
+        {
+            if (name)
+                Profiler::record(name, start, Profiler::getTime());
+        }
+
+    private:
+        const char* name = nullptr;
+        uint64_t start = 0;
+    };
+
+public:
+    static void start();
+    static void stop();
+    // Moves events recorded by all threads into the capture, call once per frame
+    static void update();
+    // Writes the capture in Chrome trace event format
+    static void save(const fs::path& file);
+    static void clear();
+
+    static void setThreadName(std::string_view name);
+    static void record(const char* name, uint64_t start, uint64_t end);
+    // Tracks are timelines that don't belong to a thread, e.g. GPU work
+    static uint32_t addTrack(std::string_view name);
+    static void record(uint32_t track, const char* name, uint64_t start, uint64_t end);
+
+    static bool isCapturing() { return capturing.load(std::memory_order_relaxed); }
+    static uint64_t getTime() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count(); }
+    static size_t getDroppedEvents() { return dropped_events; }
+
+private:
+    static constexpr size_t THREAD_BUFFER_CAPACITY = 16384; // Events a thread can record between updates
+
+    struct ThreadBuffer;
+    static ThreadBuffer& getThreadBuffer();
+
+private:
+    static inline std::atomic<bool> capturing = false;
+    static inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    static inline std::vector<shared<ThreadBuffer>> buffers;
+    static inline std::vector<Event> events;
+    static inline std::atomic<size_t> dropped_events = 0;
+    static inline std::mutex mutex;
+};
+
+#ifdef SK_ENABLE_DEBUG_OUTPUT
+    #define SK_PROFILE_CONCAT_IMPL(a, b) a##b
+    #define SK_PROFILE_CONCAT(a, b) SK_PROFILE_CONCAT_IMPL(a, b)
+    #define SK_PROFILE_SCOPE(name) Profiler::Scope SK_PROFILE_CONCAT(_sk_profile_scope_, __LINE__)(name)
+    #define SK_PROFILE_FUNCTION() SK_PROFILE_SCOPE(__FUNCTION__)
+#else
+    #define SK_PROFILE_SCOPE(name)
+    #define SK_PROFILE_FUNCTION()
+#endif
\ No newline at end of file
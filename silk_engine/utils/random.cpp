@@ -0,0 +1,111 @@
+#include "random_kernels.h"
+#include "cpu.h"
+
+const Random::Kernels::Table* Random::Kernels::getTable()
+{
+    switch (CPU::getSimdLevel())
+    {
+    case CPU::SimdLevel::AVX2: return &getAVX2();
+    case CPU::SimdLevel::SSE41: return &getSSE41();
+    case CPU::SimdLevel::SCALAR: break;
+    }
+    return nullptr;
+}
+
+void Random::noise(std::span<const float> x, std::span<const float> y, std::span<float> out)
+{
+    SK_ASSERT(x.size() >= out.size() && y.size() >= out.size(), "Random: Not enough points for output");
+    Kernels::dispatch(out.size(),
+        [&](const Kernels::Table& table) { return table.noise2(x.data(), y.data(), out.data(), out.size()); },
+        [&](size_t i) { out[i] = noise(x[i], y[i]); });
+}
+
+void Random::noise(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out)
+{
+    SK_ASSERT(x.size() >= out.size() && y.size() >= out.size() && z.size() >= out.size(), "Random: Not enough points for output");
+    Kernels::dispatch(out.size(),
+        [&](const Kernels::Table& table) { return table.noise3(x.data(), y.data(), z.data(), out.data(), out.size()); },
+        [&](size_t i) { out[i] = noise(x[i], y[i], z[i]); });
+}
+
+void Random::fbm(size_t octaves, std::span<const float> x, std::span<const float> y, float lacunarity, float persistance, std::span<float> out)
+{
+    SK_ASSERT(x.size() >= out.size() && y.size() >= out.size(), "Random: Not enough points for output");
+    Kernels::dispatch(out.size(),
+        [&](const Kernels::Table& table) { return table.fbm2(octaves, x.data(), y.data(), lacunarity, persistance, out.data(), out.size()); },
+        [&](size_t i) { out[i] = fbm(octaves, x[i], y[i], lacunarity, persistance); });
+}
+
+void Random::fbm(size_t octaves, std::span<const float> x, std::span<const float> y, std::span<const float> z, float lacunarity, float persistance, std::span<float> out)
+{
+    SK_ASSERT(x.size() >= out.size() && y.size() >= out.size() && z.size() >= out.size(), "Random: Not enough points for output");
+    Kernels::dispatch(out.size(),
+        [&](const Kernels::Table& table) { return table.fbm3(octaves, x.data(), y.data(), z.data(), lacunarity, persistance, out.data(), out.size()); },
+        [&](size_t i) { out[i] = fbm(octaves, x[i], y[i], z[i], lacunarity, persistance); });
+}
+
+Random::Stream::Stream(uint64_t seed)
+{
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        uint64_t a = next64(seed);
+        uint64_t b = next64(seed);
+        s0[lane] = uint32_t(a);
+        s1[lane] = uint32_t(a >> 32);
+        s2[lane] = uint32_t(b);
+        s3[lane] = uint32_t(b >> 32);
+    }
+}
+
+uint32_t Random::Stream::next()
+{
+    if (!buffered)
+    {
+        step(buffer.data());
+        buffered = LANES;
+    }
+    return buffer[LANES - buffered--];
+}
+
+void Random::Stream::fill(std::span<uint32_t> values)
+{
+    size_t i = 0;
+    for (; i < values.size() && buffered; ++i)
+        values[i] = next();
+    for (; i + LANES <= values.size(); i += LANES)
+        step(values.data() + i);
+    for (; i < values.size(); ++i)
+        values[i] = next();
+}
+
+void Random::Stream::fill(std::span<float> values)
+{
+    std::array<uint32_t, 256> integers;
+    for (size_t offset = 0; offset < values.size(); offset += integers.size())
+    {
+        size_t count = std::min(integers.size(), values.size() - offset);
+        fill(std::span(integers.data(), count));
+        for (size_t i = 0; i < count; ++i)
+            values[offset + i] = toFloat(integers[i]);
+    }
+}
+
+void Random::Stream::step(uint32_t* values)
+{
+    if (const Kernels::Table* table = Kernels::getTable())
+    {
+        table->step(s0.data(), s1.data(), s2.data(), s3.data(), values);
+        return;
+    }
+    for (size_t lane = 0; lane < LANES; ++lane)
+    {
+        values[lane] = s0[lane] + s3[lane];
+        uint32_t t = s1[lane] << 9;
+        s2[lane] ^= s0[lane];
+        s3[lane] ^= s1[lane];
+        s1[lane] ^= s2[lane];
+        s0[lane] ^= s3[lane];
+        s2[lane] ^= t;
+        s3[lane] = std::rotl(s3[lane], 11);
+    }
+}
\ No newline at end of file
@@ -5,6 +5,37 @@ class Random
 public:
     static inline uint64_t seed = 3773452183ULL;
 
+    // xoshiro128+ generators running in LANES interleaved lanes: value n comes from lane n % LANES,
+    // so fill() advances all lanes at once with SIMD and gives the same sequence as calling next() repeatedly
+    class Stream
+    {
+    public:
+        static constexpr size_t LANES = 8;
+
+    public:
+        Stream(uint64_t seed = Random::seed);
+
+        uint32_t next();
+        // Uniform in [0, 1)
+        float nextFloat() { return toFloat(next()); }
+        void fill(std::span<uint32_t> values);
+        void fill(std::span<float> values);
+
+        static float toFloat(uint32_t value) { return float(value >> 8) * 0x1.0p-24f; }
+
+    private:
+        // Advances every lane once, writing one value per lane
+        void step(uint32_t* values);
+
+    private:
+        alignas(32) std::array<uint32_t, LANES> s0 = {};
+        alignas(32) std::array<uint32_t, LANES> s1 = {};
+        alignas(32) std::array<uint32_t, LANES> s2 = {};
+        alignas(32) std::array<uint32_t, LANES> s3 = {};
+        std::array<uint32_t, LANES> buffer = {};
+        size_t buffered = 0; // Values of the last step not handed out yet, taken from the back of buffer
+    };
+
 public:
     template <typename T>
     static T get(uint64_t seed)
@@ -253,7 +284,16 @@ public:
         return (output / denom);
     }
 
+    // Batched versions fill out[i] from the i-th point, using AVX2 or SSE4.1 (picked at runtime) for whole
+    // groups of points. Results are bit identical to the scalar functions above
+    static void noise(std::span<const float> x, std::span<const float> y, std::span<float> out);
+    static void noise(std::span<const float> x, std::span<const float> y, std::span<const float> z, std::span<float> out);
+    static void fbm(size_t octaves, std::span<const float> x, std::span<const float> y, float lacunarity, float persistance, std::span<float> out);
+    static void fbm(size_t octaves, std::span<const float> x, std::span<const float> y, std::span<const float> z, float lacunarity, float persistance, std::span<float> out);
+
 private:
+    struct Kernels;
+
     static uint64_t next64(uint64_t& seed)
     {
         uint64_t z = (seed += 0x9E3779B97F4A7C15);
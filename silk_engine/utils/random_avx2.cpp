@@ -0,0 +1,51 @@
+#include "silk_engine/core/base.h" // Built without the precompiled header, see CMakeLists.txt
+#include "random_kernels.h"
+#include <immintrin.h>
+
+namespace
+{
+    struct AVX2
+    {
+        using F = __m256;
+        using I = __m256i;
+        static constexpr size_t WIDTH = 8;
+
+        static F load(const float* data) { return _mm256_loadu_ps(data); }
+        static void store(float* data, F v) { _mm256_storeu_ps(data, v); }
+        static F set(float v) { return _mm256_set1_ps(v); }
+        static F add(F a, F b) { return _mm256_add_ps(a, b); }
+        static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+        static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+        static F div(F a, F b) { return _mm256_div_ps(a, b); }
+        static F neg(F a) { return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f)); }
+        static F lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static F gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+        static F ge(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+        static F select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+        static F toFloat(I a) { return _mm256_cvtepi32_ps(a); }
+        static F mask(I a) { return _mm256_castsi256_ps(a); }
+
+        static I seti(int32_t v) { return _mm256_set1_epi32(v); }
+        static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+        static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+        static I eqi(I a, I b) { return _mm256_cmpeq_epi32(a, b); }
+        static I lti(I a, I b) { return _mm256_cmpgt_epi32(b, a); }
+        static I truncate(F a) { return _mm256_cvttps_epi32(a); }
+        static I maski(F a) { return _mm256_castps_si256(a); }
+        static I gather(const int32_t* table, I index) { return _mm256_i32gather_epi32(table, index, 4); }
+
+        static I loadi(const uint32_t* data) { return _mm256_load_si256(rcast<const I*>(data)); }
+        static void storei(uint32_t* data, I v) { _mm256_storeu_si256(rcast<I*>(data), v); }
+        static void storeia(uint32_t* data, I v) { _mm256_store_si256(rcast<I*>(data), v); }
+        static I xori(I a, I b) { return _mm256_xor_si256(a, b); }
+        static I ori(I a, I b) { return _mm256_or_si256(a, b); }
+        template<int N> static I shl(I a) { return _mm256_slli_epi32(a, N); }
+        template<int N> static I shr(I a) { return _mm256_srli_epi32(a, N); }
+    };
+}
+
+const Random::Kernels::Table& Random::Kernels::getAVX2()
+{
+    static constexpr Table table = makeTable<AVX2>();
+    return table;
+}
\ No newline at end of file
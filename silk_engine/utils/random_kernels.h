@@ -0,0 +1,279 @@
+#pragma once
+
+#include "random.h"
+
+// Batch kernels written once against an instruction set wrapper V, which random_sse41.cpp and random_avx2.cpp define.
+// Mirrors the scalar noise operation for operation, so every lane rounds exactly like the scalar version
+struct Random::Kernels
+{
+    static constexpr std::array<int32_t, 256> PERM = []
+    {
+        std::array<int32_t, 256> perm{};
+        for (size_t i = 0; i < perm.size(); ++i)
+            perm[i] = Random::perm[i];
+        return perm;
+    }();
+
+    template<typename V>
+    static typename V::I hash(typename V::I i)
+    {
+        return V::gather(PERM.data(), V::andi(i, V::seti(255)));
+    }
+
+    template<typename V>
+    static typename V::I fastfloor(typename V::F x)
+    {
+        typename V::I i = V::truncate(x);
+        return V::addi(i, V::maski(V::lt(x, V::toFloat(i)))); // Mask is -1 where x < i
+    }
+
+    template<typename V>
+    static typename V::F falloff(typename V::F t, typename V::F gradient)
+    {
+        typename V::F t2 = V::mul(t, t);
+        return V::select(V::lt(t, V::set(0.0f)), V::set(0.0f), V::mul(V::mul(t2, t2), gradient));
+    }
+
+    template<typename V>
+    static typename V::F grad(typename V::I hash, typename V::F x, typename V::F y)
+    {
+        typename V::I h = V::andi(hash, V::seti(0x3F));
+        typename V::F below4 = V::mask(V::lti(h, V::seti(4)));
+        typename V::F u = V::select(below4, x, y);
+        typename V::F v = V::mul(V::set(2.0f), V::select(below4, y, x));
+        u = V::select(V::mask(V::eqi(V::andi(h, V::seti(1)), V::seti(1))), V::neg(u), u);
+        v = V::select(V::mask(V::eqi(V::andi(h, V::seti(2)), V::seti(2))), V::neg(v), v);
+        return V::add(u, v);
+    }
+
+    template<typename V>
+    static typename V::F grad(typename V::I hash, typename V::F x, typename V::F y, typename V::F z)
+    {
+        typename V::I h = V::andi(hash, V::seti(15));
+        typename V::F u = V::select(V::mask(V::lti(h, V::seti(8))), x, y);
+        typename V::F x_or_z = V::select(V::mask(V::eqi(h, V::seti(12))), x, V::select(V::mask(V::eqi(h, V::seti(14))), x, z));
+        typename V::F v = V::select(V::mask(V::lti(h, V::seti(4))), y, x_or_z);
+        u = V::select(V::mask(V::eqi(V::andi(h, V::seti(1)), V::seti(1))), V::neg(u), u);
+        v = V::select(V::mask(V::eqi(V::andi(h, V::seti(2)), V::seti(2))), V::neg(v), v);
+        return V::add(u, v);
+    }
+
+    template<typename V>
+    static typename V::F noise(typename V::F x, typename V::F y)
+    {
+        using F = typename V::F;
+        using I = typename V::I;
+        constexpr float F2 = 0.366025403f;
+        constexpr float G2 = 0.211324865f;
+        F s = V::mul(V::add(x, y), V::set(F2));
+        I i = fastfloor<V>(V::add(x, s));
+        I j = fastfloor<V>(V::add(y, s));
+        F t = V::mul(V::toFloat(V::addi(i, j)), V::set(G2));
+        F x0 = V::sub(x, V::sub(V::toFloat(i), t));
+        F y0 = V::sub(y, V::sub(V::toFloat(j), t));
+        F upper = V::gt(x0, y0);
+        I i1 = V::andi(V::maski(upper), V::seti(1));
+        I j1 = V::xori(i1, V::seti(1));
+        F x1 = V::add(V::sub(x0, V::toFloat(i1)), V::set(G2));
+        F y1 = V::add(V::sub(y0, V::toFloat(j1)), V::set(G2));
+        F x2 = V::add(V::sub(x0, V::set(1.0f)), V::set(2.0f * G2));
+        F y2 = V::add(V::sub(y0, V::set(1.0f)), V::set(2.0f * G2));
+        I gi0 = hash<V>(V::addi(i, hash<V>(j)));
+        I gi1 = hash<V>(V::addi(V::addi(i, i1), hash<V>(V::addi(j, j1))));
+        I gi2 = hash<V>(V::addi(V::addi(i, V::seti(1)), hash<V>(V::addi(j, V::seti(1)))));
+        F t0 = V::sub(V::sub(V::set(0.5f), V::mul(x0, x0)), V::mul(y0, y0));
+        F t1 = V::sub(V::sub(V::set(0.5f), V::mul(x1, x1)), V::mul(y1, y1));
+        F t2 = V::sub(V::sub(V::set(0.5f), V::mul(x2, x2)), V::mul(y2, y2));
+        F n0 = falloff<V>(t0, grad<V>(gi0, x0, y0));
+        F n1 = falloff<V>(t1, grad<V>(gi1, x1, y1));
+        F n2 = falloff<V>(t2, grad<V>(gi2, x2, y2));
+        return V::mul(V::set(45.23065f), V::add(V::add(n0, n1), n2));
+    }
+
+    template<typename V>
+    static typename V::F noise(typename V::F x, typename V::F y, typename V::F z)
+    {
+        using F = typename V::F;
+        using I = typename V::I;
+        constexpr float F3 = 1.0f / 3.0f;
+        constexpr float G3 = 1.0f / 6.0f;
+        F s = V::mul(V::add(V::add(x, y), z), V::set(F3));
+        I i = fastfloor<V>(V::add(x, s));
+        I j = fastfloor<V>(V::add(y, s));
+        I k = fastfloor<V>(V::add(z, s));
+        F t = V::mul(V::toFloat(V::addi(V::addi(i, j), k)), V::set(G3));
+        F x0 = V::sub(x, V::sub(V::toFloat(i), t));
+        F y0 = V::sub(y, V::sub(V::toFloat(j), t));
+        F z0 = V::sub(z, V::sub(V::toFloat(k), t));
+
+        // Same simplex corner table as the scalar version, as masks
+        I xy = V::maski(V::ge(x0, y0));
+        I yz = V::maski(V::ge(y0, z0));
+        I xz = V::maski(V::ge(x0, z0));
+        I all = V::seti(-1);
+        I not_xy = V::xori(xy, all);
+        I not_yz = V::xori(yz, all);
+        I not_xz = V::xori(xz, all);
+        I one = V::seti(1);
+        I i1 = V::andi(V::andi(xy, V::ori(yz, xz)), one);
+        I j1 = V::andi(V::andi(not_xy, yz), one);
+        I k1 = V::andi(V::andi(not_yz, V::ori(not_xy, not_xz)), one);
+        I i2 = V::andi(V::ori(xy, V::andi(yz, xz)), one);
+        I j2 = V::andi(V::ori(not_xy, yz), one);
+        I k2 = V::andi(V::ori(not_yz, V::andi(not_xy, not_xz)), one);
+
+        F x1 = V::add(V::sub(x0, V::toFloat(i1)), V::set(G3));
+        F y1 = V::add(V::sub(y0, V::toFloat(j1)), V::set(G3));
+        F z1 = V::add(V::sub(z0, V::toFloat(k1)), V::set(G3));
+        F x2 = V::add(V::sub(x0, V::toFloat(i2)), V::set(2.0f * G3));
+        F y2 = V::add(V::sub(y0, V::toFloat(j2)), V::set(2.0f * G3));
+        F z2 = V::add(V::sub(z0, V::toFloat(k2)), V::set(2.0f * G3));
+        F x3 = V::add(V::sub(x0, V::set(1.0f)), V::set(3.0f * G3));
+        F y3 = V::add(V::sub(y0, V::set(1.0f)), V::set(3.0f * G3));
+        F z3 = V::add(V::sub(z0, V::set(1.0f)), V::set(3.0f * G3));
+        I gi0 = hash<V>(V::addi(i, hash<V>(V::addi(j, hash<V>(k)))));
+        I gi1 = hash<V>(V::addi(V::addi(i, i1), hash<V>(V::addi(V::addi(j, j1), hash<V>(V::addi(k, k1))))));
+        I gi2 = hash<V>(V::addi(V::addi(i, i2), hash<V>(V::addi(V::addi(j, j2), hash<V>(V::addi(k, k2))))));
+        I gi3 = hash<V>(V::addi(V::addi(i, one), hash<V>(V::addi(V::addi(j, one), hash<V>(V::addi(k, one))))));
+        F t0 = V::sub(V::sub(V::sub(V::set(0.6f), V::mul(x0, x0)), V::mul(y0, y0)), V::mul(z0, z0));
+        F t1 = V::sub(V::sub(V::sub(V::set(0.6f), V::mul(x1, x1)), V::mul(y1, y1)), V::mul(z1, z1));
+        F t2 = V::sub(V::sub(V::sub(V::set(0.6f), V::mul(x2, x2)), V::mul(y2, y2)), V::mul(z2, z2));
+        F t3 = V::sub(V::sub(V::sub(V::set(0.6f), V::mul(x3, x3)), V::mul(y3, y3)), V::mul(z3, z3));
+        F n0 = falloff<V>(t0, grad<V>(gi0, x0, y0, z0));
+        F n1 = falloff<V>(t1, grad<V>(gi1, x1, y1, z1));
+        F n2 = falloff<V>(t2, grad<V>(gi2, x2, y2, z2));
+        F n3 = falloff<V>(t3, grad<V>(gi3, x3, y3, z3));
+        return V::mul(V::set(32.0f), V::add(V::add(V::add(n0, n1), n2), n3));
+    }
+
+    // Calls function(offset) for every full group of WIDTH points and returns where the scalar tail starts
+    template<typename V, typename Fn>
+    static size_t forEachGroup(size_t count, Fn&& function)
+    {
+        size_t offset = 0;
+        for (; offset + V::WIDTH <= count; offset += V::WIDTH)
+            function(offset);
+        return offset;
+    }
+
+    template<typename V>
+    static size_t noise(const float* x, const float* y, float* out, size_t count)
+    {
+        return forEachGroup<V>(count, [&](size_t offset) { V::store(out + offset, noise<V>(V::load(x + offset), V::load(y + offset))); });
+    }
+
+    template<typename V>
+    static size_t noise(const float* x, const float* y, const float* z, float* out, size_t count)
+    {
+        return forEachGroup<V>(count, [&](size_t offset) { V::store(out + offset, noise<V>(V::load(x + offset), V::load(y + offset), V::load(z + offset))); });
+    }
+
+    template<typename V>
+    static size_t fbm(size_t octaves, const float* x, const float* y, float lacunarity, float persistance, float* out, size_t count)
+    {
+        return forEachGroup<V>(count, [&](size_t offset)
+        {
+            typename V::F px = V::load(x + offset);
+            typename V::F py = V::load(y + offset);
+            typename V::F output = V::set(0.0f);
+            float denom = 0.0f;
+            float frequency = 1.0f;
+            float amplitude = 1.0f;
+            for (size_t i = 0; i < octaves; i++)
+            {
+                output = V::add(output, V::mul(V::set(amplitude), noise<V>(V::mul(px, V::set(frequency)), V::mul(py, V::set(frequency)))));
+                denom += amplitude;
+                frequency *= lacunarity;
+                amplitude *= persistance;
+            }
+            V::store(out + offset, V::div(output, V::set(denom)));
+        });
+    }
+
+    template<typename V>
+    static size_t fbm(size_t octaves, const float* x, const float* y, const float* z, float lacunarity, float persistance, float* out, size_t count)
+    {
+        return forEachGroup<V>(count, [&](size_t offset)
+        {
+            typename V::F px = V::load(x + offset);
+            typename V::F py = V::load(y + offset);
+            typename V::F pz = V::load(z + offset);
+            typename V::F output = V::set(0.0f);
+            float denom = 0.0f;
+            float frequency = 1.0f;
+            float amplitude = 1.0f;
+            for (size_t i = 0; i < octaves; i++)
+            {
+                output = V::add(output, V::mul(V::set(amplitude), noise<V>(V::mul(px, V::set(frequency)), V::mul(py, V::set(frequency)), V::mul(pz, V::set(frequency)))));
+                denom += amplitude;
+                frequency *= lacunarity;
+                amplitude *= persistance;
+            }
+            V::store(out + offset, V::div(output, V::set(denom)));
+        });
+    }
+
+    // xoshiro128+ on WIDTH lanes at a time
+    template<typename V>
+    static void step(uint32_t* s0, uint32_t* s1, uint32_t* s2, uint32_t* s3, uint32_t* values)
+    {
+        for (size_t lane = 0; lane < Stream::LANES; lane += V::WIDTH)
+        {
+            typename V::I a = V::loadi(s0 + lane);
+            typename V::I b = V::loadi(s1 + lane);
+            typename V::I c = V::loadi(s2 + lane);
+            typename V::I d = V::loadi(s3 + lane);
+            V::storei(values + lane, V::addi(a, d));
+            typename V::I t = V::template shl<9>(b);
+            c = V::xori(c, a);
+            d = V::xori(d, b);
+            b = V::xori(b, c);
+            a = V::xori(a, d);
+            c = V::xori(c, t);
+            d = V::ori(V::template shl<11>(d), V::template shr<21>(d));
+            V::storeia(s0 + lane, a);
+            V::storeia(s1 + lane, b);
+            V::storeia(s2 + lane, c);
+            V::storeia(s3 + lane, d);
+        }
+    }
+
+    // Entry points compiled for one instruction set, the batch ones return where the scalar tail starts
+    struct Table
+    {
+        size_t(*noise2)(const float* x, const float* y, float* out, size_t count);
+        size_t(*noise3)(const float* x, const float* y, const float* z, float* out, size_t count);
+        size_t(*fbm2)(size_t octaves, const float* x, const float* y, float lacunarity, float persistance, float* out, size_t count);
+        size_t(*fbm3)(size_t octaves, const float* x, const float* y, const float* z, float lacunarity, float persistance, float* out, size_t count);
+        void(*step)(uint32_t* s0, uint32_t* s1, uint32_t* s2, uint32_t* s3, uint32_t* values);
+    };
+
+    template<typename V>
+    static constexpr Table makeTable()
+    {
+        Table table{};
+        table.noise2 = [](const float* x, const float* y, float* out, size_t count) { return noise<V>(x, y, out, count); };
+        table.noise3 = [](const float* x, const float* y, const float* z, float* out, size_t count) { return noise<V>(x, y, z, out, count); };
+        table.fbm2 = [](size_t octaves, const float* x, const float* y, float lacunarity, float persistance, float* out, size_t count) { return fbm<V>(octaves, x, y, lacunarity, persistance, out, count); };
+        table.fbm3 = [](size_t octaves, const float* x, const float* y, const float* z, float lacunarity, float persistance, float* out, size_t count) { return fbm<V>(octaves, x, y, z, lacunarity, persistance, out, count); };
+        table.step = &step<V>;
+        return table;
+    }
+
+    // Each in its own file compiled for the instruction set, the rest of the engine is built for the baseline
+    static const Table& getSSE41();
+    static const Table& getAVX2();
+    // Table of the best instruction set, nullptr on the scalar path
+    static const Table* getTable();
+
+    // Runs kernel on the best instruction set, the scalar function finishes the points that don't fill a group
+    template<typename Kernel, typename Scalar>
+    static void dispatch(size_t count, Kernel&& kernel, Scalar&& scalar)
+    {
+        size_t offset = 0;
+        if (const Table* table = getTable())
+            offset = kernel(*table);
+        for (; offset < count; ++offset)
+            scalar(offset);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "silk_engine/core/base.h" // Built without the precompiled header, see CMakeLists.txt
+#include "random_kernels.h"
+#include <immintrin.h>
+
+namespace
+{
+    struct SSE41
+    {
+        using F = __m128;
+        using I = __m128i;
+        static constexpr size_t WIDTH = 4;
+
+        static F load(const float* data) { return _mm_loadu_ps(data); }
+        static void store(float* data, F v) { _mm_storeu_ps(data, v); }
+        static F set(float v) { return _mm_set1_ps(v); }
+        static F add(F a, F b) { return _mm_add_ps(a, b); }
+        static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+        static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+        static F div(F a, F b) { return _mm_div_ps(a, b); }
+        static F neg(F a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+        static F lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+        static F gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+        static F ge(F a, F b) { return _mm_cmpge_ps(a, b); }
+        static F select(F mask, F a, F b) { return _mm_blendv_ps(b, a, mask); }
+        static F toFloat(I a) { return _mm_cvtepi32_ps(a); }
+        static F mask(I a) { return _mm_castsi128_ps(a); }
+
+        static I seti(int32_t v) { return _mm_set1_epi32(v); }
+        static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+        static I andi(I a, I b) { return _mm_and_si128(a, b); }
+        static I eqi(I a, I b) { return _mm_cmpeq_epi32(a, b); }
+        static I lti(I a, I b) { return _mm_cmplt_epi32(a, b); }
+        static I truncate(F a) { return _mm_cvttps_epi32(a); }
+        static I maski(F a) { return _mm_castps_si128(a); }
+        static I gather(const int32_t* table, I index)
+        {
+            alignas(16) int32_t indices[WIDTH];
+            _mm_store_si128(rcast<I*>(indices), index);
+            return _mm_setr_epi32(table[indices[0]], table[indices[1]], table[indices[2]], table[indices[3]]);
+        }
+
+        static I loadi(const uint32_t* data) { return _mm_load_si128(rcast<const I*>(data)); }
+        static void storei(uint32_t* data, I v) { _mm_storeu_si128(rcast<I*>(data), v); }
+        static void storeia(uint32_t* data, I v) { _mm_store_si128(rcast<I*>(data), v); }
+        static I xori(I a, I b) { return _mm_xor_si128(a, b); }
+        static I ori(I a, I b) { return _mm_or_si128(a, b); }
+        template<int N> static I shl(I a) { return _mm_slli_epi32(a, N); }
+        template<int N> static I shr(I a) { return _mm_srli_epi32(a, N); }
+    };
+}
+
+const Random::Kernels::Table& Random::Kernels::getSSE41()
+{
+    static constexpr Table table = makeTable<SSE41>();
+    return table;
+}
\ No newline at end of file
@@ -25,4 +25,38 @@ std::string String::replaceFirst(std::string str, std::string_view token, std::s
 
 	str.replace(start_pos, token.length(), to);
 	return str;
+}
+
+std::string String::escapeJson(std::string_view str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"': escaped += "\\\""; break;
+		case '\\': escaped += "\\\\"; break;
+		case '\n': escaped += "\\n"; break;
+		case '\r': escaped += "\\r"; break;
+		case '\t': escaped += "\\t"; break;
+		default:
+			if (uint8_t(c) < 0x20)
+				escaped += std::format("\\u{:04x}", uint8_t(c));
+			else escaped += c;
+		}
+	}
+	return escaped;
+}
+
+std::string String::quoteCsv(std::string_view str)
+{
+	std::string quoted = "\"";
+	for (char c : str)
+	{
+		if (c == '"')
+			quoted += '"';
+		quoted += c;
+	}
+	return quoted + "\"";
 }
\ No newline at end of file
@@ -6,4 +6,8 @@ class String
 public:
 	static std::vector<std::string> split(std::string_view str, char delimeter = ' ');
 	static std::string replaceFirst(std::string str, std::string_view token, std::string_view to);
+	// Escapes quotes, backslashes and control characters for use inside a JSON string
+	static std::string escapeJson(std::string_view str);
+	// Wraps in quotes and doubles the quotes inside, so commas and line breaks stay in one CSV field
+	static std::string quoteCsv(std::string_view str);
 };
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "string_id.h"
+#include "hash_map.h"
+#include <shared_mutex>
+#include <deque>
+
+namespace
+{
+    struct InternTable
+    {
+        std::shared_mutex mutex;
+        std::deque<std::string> strings; // Deque never moves its elements, so views into them stay valid
+        HashMap<StringId, std::string_view> views;
+    };
+
+    InternTable& getInternTable()
+    {
+        static InternTable table;
+        return table;
+    }
+}
+
+std::string_view StringId::getString() const
+{
+    InternTable& table = getInternTable();
+    std::shared_lock lock(table.mutex);
+    if (auto it = table.views.find(*this); it != table.views.end())
+        return it->second;
+    return {};
+}
+
+StringId StringId::intern(std::string_view string)
+{
+    StringId id(string);
+    InternTable& table = getInternTable();
+    {
+        std::shared_lock lock(table.mutex);
+        if (auto it = table.views.find(id); it != table.views.end())
+        {
+            SK_VERIFY(it->second == string, "StringId: \"{}\" and \"{}\" have the same id {}", it->second, string, id.getId());
+            return id;
+        }
+    }
+    std::unique_lock lock(table.mutex);
+    if (!table.views.contains(id))
+        table.views.emplace(id, table.strings.emplace_back(string));
+    return id;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+// 32 bit FNV-1a hash of a name, the same in every run and computed at compile time for "name"_id literals.
+// Registries key by it, so lookups compare integers and keys don't reference strings they don't own.
+// intern() keeps a copy of the string in a global table, for getString(), and reports names that collide
+class StringId
+{
+public:
+    constexpr StringId() = default;
+    constexpr StringId(std::string_view string)
+        : id(hash(string)) {}
+    constexpr StringId(const char* string)
+        : StringId(std::string_view(string)) {}
+    StringId(const std::string& string)
+        : StringId(std::string_view(string)) {}
+
+    constexpr uint32_t getId() const { return id; }
+    // Null terminated, empty if no string with this id was interned
+    std::string_view getString() const;
+
+    constexpr bool operator==(const StringId& other) const = default;
+    constexpr auto operator<=>(const StringId& other) const = default;
+
+public:
+    static StringId intern(std::string_view string);
+
+    static constexpr uint32_t hash(std::string_view string)
+    {
+        uint32_t hash = 0x811C9DC5;
+        for (char c : string)
+        {
+            hash ^= uint8_t(c);
+            hash *= 0x01000193;
+        }
+        return hash;
+    }
+
+private:
+    uint32_t id = 0;
+};
+
+consteval StringId operator""_id(const char* string, size_t size)
+{
+    return StringId(std::string_view(string, size));
+}
\ No newline at end of file
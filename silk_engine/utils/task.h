@@ -0,0 +1,192 @@
+#pragma once
+
+#include <coroutine>
+
+template<typename T>
+class Task;
+
+class TaskPromiseBase
+{
+    template<typename T>
+    friend class Task;
+
+private:
+    // state holds the awaiting coroutine's address or one of these, frames are aligned so they never collide
+    static constexpr uintptr_t NONE = 0;
+    static constexpr uintptr_t FINISHED = 1;
+    static constexpr uintptr_t DETACHED = 2; // Nobody owns the Task anymore, the frame destroys itself when finished
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            uintptr_t previous = handle.promise().state.exchange(FINISHED, std::memory_order_acq_rel);
+            if (previous == DETACHED)
+                handle.destroy();
+            else if (previous != NONE)
+                return std::coroutine_handle<>::from_address(rcast<void*>(previous));
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+public:
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { exception = std::current_exception(); }
+
+    void rethrow() const
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    bool isFinished() const { return state.load(std::memory_order_acquire) == FINISHED; }
+
+private:
+    // The coroutine may finish on another thread while its owner awaits or detaches it, whoever comes second
+    // in the exchange on state resumes the awaiter or destroys the frame
+    std::atomic<uintptr_t> state = NONE;
+    bool started = false; // Only touched by the owner, so a started task is never resumed again from outside
+    std::exception_ptr exception = nullptr;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+    T& get()
+    {
+        rethrow();
+        return *result;
+    }
+
+private:
+    std::optional<T> result = std::nullopt;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object();
+
+    void return_void() const {}
+    void get() const { rethrow(); }
+};
+
+// Lazily started coroutine, it runs when awaited (the awaiter is resumed once it finishes) or when started.
+// Where it continues after co_await depends on the awaited thing, see TaskScheduler for the engine awaiters.
+// A started task has to be awaited until done or detached before it's destroyed, its frame may still be suspended on another thread
+template<typename T = void>
+class Task : NoCopy
+{
+public:
+    using promise_type = TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+public:
+    Task() = default;
+    explicit Task(Handle handle)
+        : handle(handle) {}
+    Task(Task&& other) noexcept
+        : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task() { destroy(); }
+
+    // Runs the coroutine on the calling thread until its first suspension, for starting tasks outside of coroutines.
+    // Does nothing if it was already started or awaited
+    void start()
+    {
+        if (!handle || handle.promise().started)
+            return;
+        handle.promise().started = true;
+        handle.resume();
+    }
+
+    // Gives up ownership and starts the coroutine if it wasn't yet, the frame is destroyed when it finishes
+    // (right away if it already has)
+    void detach()
+    {
+        if (!handle)
+            return;
+        Handle detached = std::exchange(handle, nullptr);
+        TaskPromiseBase& promise = detached.promise();
+        if (!promise.started)
+        {
+            promise.started = true;
+            promise.state.store(TaskPromiseBase::DETACHED, std::memory_order_relaxed);
+            detached.resume();
+        }
+        else if (promise.state.exchange(TaskPromiseBase::DETACHED, std::memory_order_acq_rel) == TaskPromiseBase::FINISHED)
+            detached.destroy();
+    }
+
+    bool isValid() const { return handle != nullptr; }
+    bool isDone() const { return !handle || handle.promise().isFinished(); }
+
+    // Only valid once isDone()
+    decltype(auto) get() { return handle.promise().get(); }
+
+    auto operator co_await() & noexcept { return Awaiter{ handle }; }
+    auto operator co_await() && noexcept { return Awaiter{ handle }; }
+
+private:
+    struct Awaiter
+    {
+        Handle handle;
+
+        bool await_ready() const noexcept { return !handle || handle.promise().isFinished(); }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            TaskPromiseBase& promise = handle.promise();
+            uintptr_t continuation = rcast<uintptr_t>(awaiting.address());
+            if (!promise.started)
+            {
+                promise.started = true;
+                promise.state.store(continuation, std::memory_order_relaxed);
+                return handle;
+            }
+            // Already running elsewhere, it resumes the awaiter when it finishes unless it just did
+            if (promise.state.exchange(continuation, std::memory_order_acq_rel) == TaskPromiseBase::FINISHED)
+                return awaiting;
+            return std::noop_coroutine();
+        }
+        auto await_resume()
+        {
+            if constexpr (std::is_void_v<T>)
+                handle.promise().get();
+            else return std::move(handle.promise().get());
+        }
+    };
+
+    void destroy()
+    {
+        SK_ASSERT(!handle || !handle.promise().started || handle.promise().isFinished(), "Task: Destroying a started task that didn't finish, await or detach it instead");
+        if (handle)
+            handle.destroy();
+        handle = nullptr;
+    }
+
+private:
+    Handle handle = nullptr;
+};
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() { return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this)); }
+inline Task<void> TaskPromise<void>::get_return_object() { return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this)); }
\ No newline at end of file
@@ -1,17 +1,20 @@
 #include "thread_pool.h"
 
 ThreadPool::ThreadPool(uint thread_count)
-    : threads(thread_count)
+    : threads(std::max(thread_count, 1u)), queues(threads.size())
 {
-    for (auto& t : threads)
-        t = std::thread(&ThreadPool::work, this);
+    for (auto& queue : queues)
+        queue = makeUnique<WorkStealingDeque<Task*>>();
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i] = std::thread(&ThreadPool::work, this, i);
 }
 
 ThreadPool::~ThreadPool()
 {
-    running = false;
-    condition.notify_all();
     wait();
+    running = false;
+    ++wake_epoch;
+    wake_epoch.notify_all();
     for (auto& t : threads)
     {
         if (t.joinable())
@@ -19,29 +22,173 @@ ThreadPool::~ThreadPool()
     }
 }
 
+ThreadPool& ThreadPool::get()
+{
+    static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return pool;
+}
+
 void ThreadPool::wait()
 {
-    while (running_tasks)
-        std::this_thread::yield();
+    help(running_tasks);
+}
+
+void ThreadPool::wait(const JobCounter& counter)
+{
+    help(counter);
+}
+
+void ThreadPool::wait(const JobHandle& job)
+{
+    help(job->finished);
+}
+
+void ThreadPool::help(const std::atomic<size_t>& pending)
+{
+    size_t worker = current_pool == this ? current_worker : NOT_WORKER;
+    while (size_t remaining = pending.load())
+    {
+        if (Task* task = findTask(worker))
+            execute(task);
+        else pending.wait(remaining);
+    }
+}
+
+void ThreadPool::help(const JobCounter& counter)
+{
+    size_t worker = current_pool == this ? current_worker : NOT_WORKER;
+    while (true)
+    {
+        // The epoch is read before checking the counter, so a completion in between isn't missed
+        uint32_t epoch = JobCounter::completions.load();
+        if (counter.isDone())
+            break;
+        if (Task* task = findTask(worker))
+            execute(task);
+        else JobCounter::completions.wait(epoch);
+    }
+}
+
+void ThreadPool::push(Task* task)
+{
+    ++running_tasks;
+    if (current_pool == this)
+        queues[current_worker]->push(task);
+    else
+    {
+        std::scoped_lock lock(injection_mutex);
+        injection_queue.push(task);
+    }
+
+    ++wake_epoch;
+    if (sleeping_workers)
+        wake_epoch.notify_one();
+}
+
+void ThreadPool::addDependencies(const JobHandle& job, std::span<const JobHandle> dependencies)
+{
+    job->dependencies += dependencies.size();
+    for (const auto& dependency : dependencies)
+    {
+        if (!dependency)
+        {
+            --job->dependencies;
+            continue;
+        }
+        std::scoped_lock lock(dependency->continuation_mutex);
+        if (dependency->started_continuations)
+            --job->dependencies;
+        else dependency->continuations.emplace_back(job);
+    }
 }
 
-void ThreadPool::work()
+void ThreadPool::release(Job& job)
 {
-    while (running)
+    if (job.dependencies.fetch_sub(1) == 1)
+        job.pool->push(std::exchange(job.task, nullptr));
+}
+
+void ThreadPool::finish(Job& job)
+{
+    std::vector<JobHandle> continuations;
     {
-        std::function<void()> task = nullptr;
+        std::scoped_lock lock(job.continuation_mutex);
+        job.started_continuations = true;
+        continuations = std::move(job.continuations);
+    }
+    // Continuations are pushed before this task retires, so wait() on the whole pool still covers the ones scheduled on it
+    for (const auto& continuation : continuations)
+        release(*continuation);
+    if (job.counter)
+        job.counter->done();
+    job.finished.done();
+}
+
+ThreadPool::Task* ThreadPool::findTask(size_t worker)
+{
+    if (worker != NOT_WORKER)
+        if (auto task = queues[worker]->pop())
+            return *task;
+
+    if (auto task = injection_queue.steal())
+        return *task;
+
+    // Start stealing at a different victim per worker so thieves don't all hit the same deque
+    size_t start = worker == NOT_WORKER ? 0 : worker + 1;
+    for (size_t i = 0; i < queues.size(); ++i)
+    {
+        size_t victim = (start + i) % queues.size();
+        if (victim == worker)
+            continue;
+        if (auto task = queues[victim]->steal())
+            return *task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::execute(Task* task)
+{
+    {
+        SK_PROFILE_SCOPE("ThreadPool::execute");
+        (*task)();
+    }
+    Task::free(task);
+    if (running_tasks.fetch_sub(1) == 1)
+        running_tasks.notify_all();
+}
+
+void ThreadPool::work(size_t worker)
+{
+    current_pool = this;
+    current_worker = worker;
+    Profiler::setThreadName(std::format("Worker {}", worker));
+    while (true)
+    {
+        Task* task = nullptr;
+        for (size_t spin = 0; spin < SPIN_COUNT && !task; ++spin)
         {
-            std::unique_lock lock(queue_mutex);
-            condition.wait(lock, [this]()->bool { return tasks.size() || !running; });
-            if (tasks.empty())
-                break;
-            task = std::move(tasks.front());
-            tasks.pop();
+            if (!(task = findTask(worker)))
+                std::this_thread::yield();
         }
         if (task)
         {
-            task();
-            --running_tasks;
+            execute(task);
+            continue;
+        }
+
+        // Park until something is pushed, the epoch is read before the last look so a push in between isn't missed
+        uint32_t epoch = wake_epoch.load();
+        if ((task = findTask(worker)))
+        {
+            execute(task);
+            continue;
         }
+        if (!running)
+            break;
+        ++sleeping_workers;
+        wake_epoch.wait(epoch);
+        --sleeping_workers;
     }
+    current_pool = nullptr;
+    current_worker = NOT_WORKER;
 }
\ No newline at end of file
@@ -1,79 +1,347 @@
 #pragma once
 
 #include <future>
+#include "work_stealing_deque.h"
 
-class ThreadPool
+// Work stealing thread pool: every worker owns a Chase-Lev deque it pushes and pops from without locking,
+// idle workers steal from the others and park when there is nothing left to do.
+// Tasks submitted from outside of the pool go to a shared injection deque, that only submitters lock.
+class ThreadPool : NoCopy
 {
+private:
+    // Type erased callable that stores small closures inline, one cache line in size
+    class alignas(64) Task : NoCopy
+    {
+    public:
+        static constexpr size_t INLINE_SIZE = 64 - 2 * sizeof(void*);
+
+    public:
+        template<typename Fn>
+        Task(Fn&& function)
+        {
+            using F = std::decay_t<Fn>;
+            if constexpr (sizeof(F) <= INLINE_SIZE && alignof(F) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<F>)
+            {
+                new (storage) F(std::forward<Fn>(function));
+                invoke = [](Task& task) { (*std::launder(rcast<F*>(task.storage)))(); };
+                destroy = [](Task& task) { std::launder(rcast<F*>(task.storage))->~F(); };
+            }
+            else
+            {
+                new (storage) F*(new F(std::forward<Fn>(function)));
+                invoke = [](Task& task) { (**rcast<F**>(task.storage))(); };
+                destroy = [](Task& task) { delete *rcast<F**>(task.storage); };
+            }
+        }
+        ~Task() { destroy(*this); }
+
+        void operator()() { invoke(*this); }
+
+    public:
+        template<typename Fn>
+        static Task* allocate(Fn&& function)
+        {
+            void* memory = nullptr;
+            if (task_cache.tasks.size())
+            {
+                memory = task_cache.tasks.back();
+                task_cache.tasks.pop_back();
+            }
+            else memory = ::operator new(sizeof(Task), std::align_val_t(alignof(Task)));
+            return new (memory) Task(std::forward<Fn>(function));
+        }
+
+        static void free(Task* task)
+        {
+            task->~Task();
+            if (task_cache.tasks.size() < TaskCache::MAX_SIZE)
+                task_cache.tasks.emplace_back(task);
+            else ::operator delete(task, std::align_val_t(alignof(Task)));
+        }
+
+    private:
+        alignas(std::max_align_t) std::byte storage[INLINE_SIZE];
+        void(*invoke)(Task&) = nullptr;
+        void(*destroy)(Task&) = nullptr;
+    };
+
+    // Per thread free list of task memory, so submitting doesn't go through the global allocator
+    struct TaskCache
+    {
+        static constexpr size_t MAX_SIZE = 1024;
+
+        ~TaskCache()
+        {
+            for (void* task : tasks)
+                ::operator delete(task, std::align_val_t(alignof(Task)));
+        }
+
+        std::vector<void*> tasks;
+    };
+
+public:
+    // Counts unfinished jobs, waiting on it instead of the whole pool lets independent work keep running.
+    // A waiter may destroy the counter as soon as it reaches zero, so done() doesn't touch it after the last
+    // decrement and waiters are woken through the static completions epoch instead
+    class JobCounter : NoCopy
+    {
+        friend class ThreadPool;
+
+    public:
+        JobCounter(size_t value = 0)
+            : value(value) {}
+
+        void add(size_t count = 1) { value += count; }
+        void done()
+        {
+            if (value.fetch_sub(1) == 1)
+            {
+                ++completions;
+                completions.notify_all();
+            }
+        }
+        size_t get() const { return value; }
+        bool isDone() const { return !value; }
+
+    private:
+        static inline std::atomic<uint32_t> completions = 0;
+
+    private:
+        std::atomic<size_t> value = 0;
+    };
+
+    // Job is pushed to the pool once all of its dependencies finish, jobs depending on it are its continuations
+    class Job : NoCopy
+    {
+        friend class ThreadPool;
+
+    public:
+        bool isFinished() const { return finished.isDone(); }
+
+    private:
+        ThreadPool* pool = nullptr; // Pool the job was scheduled on, it's pushed there even when released by another pool
+        Task* task = nullptr;
+        std::atomic<uint32_t> dependencies = 1; // One extra held while scheduling, so the job can't start before all edges are added
+        std::mutex continuation_mutex;
+        std::vector<shared<Job>> continuations = {};
+        bool started_continuations = false;
+        JobCounter finished = 1;
+        JobCounter* counter = nullptr;
+    };
+    using JobHandle = shared<Job>;
+
 public:
     ThreadPool(uint thread_count = std::thread::hardware_concurrency());
     ~ThreadPool();
 
+    // Engine wide pool everything shares, so systems don't oversubscribe the cores with pools of their own.
+    // One thread fewer than cores, the thread waiting on its work helps executing it
+    static ThreadPool& get();
+
     template<typename T, typename... Args>
     void submit(T&& function, Args&&... args)
     {
-        {
-            std::scoped_lock lock(queue_mutex);
-            tasks.emplace([function, args...]
-                {
-                    function(args...);
-                });
-        }
-        ++running_tasks;
-        condition.notify_one();
+        push(Task::allocate([function = std::forward<T>(function), ...args = std::forward<Args>(args)]() mutable
+            {
+                function(args...);
+            }));
     }
 
     template<typename Fn, typename... Args, typename R = std::invoke_result_t<std::decay_t<Fn>, std::decay_t<Args>...>, typename = std::enable_if_t<!std::is_void_v<R>>>
     std::future<R> submitFuture(Fn&& function, Args&&... args)
     {
-        shared<std::promise<R>> task_promise(new std::promise<R>);
-        std::future<R> future = task_promise->get_future();
+        std::promise<R> task_promise;
+        std::future<R> future = task_promise.get_future();
+        push(Task::allocate([function = std::forward<Fn>(function), ...args = std::forward<Args>(args), task_promise = std::move(task_promise)]() mutable
+            {
+                task_promise.set_value(function(args...));
+            }));
+        return future;
+    }
+
+    // @param dependencies jobs that have to finish before this one starts, null handles are ignored
+    // @param counter incremented now and decremented once the job finishes
+    template<typename Fn>
+    JobHandle schedule(Fn&& function, std::span<const JobHandle> dependencies, JobCounter* counter = nullptr)
+    {
+        JobHandle job = makeShared<Job>();
+        job->pool = this;
+        job->counter = counter;
+        if (counter)
+            counter->add();
+        job->task = Task::allocate([job, function = std::forward<Fn>(function)]() mutable
+            {
+                function();
+                finish(*job);
+            });
+        addDependencies(job, dependencies);
+        release(*job);
+        return job;
+    }
+
+    template<typename Fn>
+    JobHandle schedule(Fn&& function, std::initializer_list<JobHandle> dependencies = {}, JobCounter* counter = nullptr)
+    {
+        return schedule(std::forward<Fn>(function), std::span<const JobHandle>(dependencies.begin(), dependencies.size()), counter);
+    }
+
+    // Runs function after job finishes (immediately if it already has)
+    template<typename Fn>
+    JobHandle then(const JobHandle& job, Fn&& function, JobCounter* counter = nullptr)
+    {
+        return schedule(std::forward<Fn>(function), { job }, counter);
+    }
+
+    // Asynchronously calls func for every index in [0, count). Workers grab chunks of indices from a shared
+    // counter, chunks shrink as the range runs out (never below grain) so uneven per index costs get balanced
+    // @param grain minimum indices per chunk, 0 picks one based on count and thread count
+    template<typename Fn>
+    void forEach(size_t count, Fn&& func, JobCounter* counter = nullptr, size_t grain = 0)
+    {
+        if (!count)
+            return;
+        grain = grain ? grain : getDefaultGrain(count);
+        size_t workers = std::min(threads.size(), (count + grain - 1) / grain);
+        size_t divisor = threads.size() * 2;
+        auto next = makeShared<std::atomic<size_t>>(0);
+        if (counter)
+            counter->add(workers);
+        for (size_t i = 0u; i < workers; ++i)
         {
-            std::scoped_lock lock(queue_mutex);
-            tasks.emplace([function, args..., task_promise]
+            submit([next, count, grain, divisor, func, counter] {
+                size_t begin = next->load(std::memory_order_relaxed);
+                while (begin < count)
                 {
-                    task_promise->set_value(function(args...));
+                    size_t chunk = std::max(grain, (count - begin) / divisor);
+                    if (!next->compare_exchange_weak(begin, begin + chunk, std::memory_order_relaxed))
+                        continue;
+                    size_t end = std::min(begin + chunk, count);
+                    for (size_t i = begin; i < end; ++i)
+                        func(i);
+                    begin = next->load(std::memory_order_relaxed);
+                }
+                if (counter)
+                    counter->done();
                 });
         }
-        ++running_tasks;
-        condition.notify_one();
-        return future;
     }
 
+    // Blocking forEach, the calling thread takes part in the work
     template<typename Fn>
-    void forEach(size_t count, Fn&& func)
+    void parallelFor(size_t count, Fn&& func, size_t grain = 0)
+    {
+        JobCounter counter;
+        forEach(count, std::forward<Fn>(func), &counter, grain);
+        wait(counter);
+    }
+
+    // reduce(...reduce(reduce(identity, map(0)), map(1))..., map(count - 1)), partial results are combined in index order
+    // so reduce only has to be associative
+    template<typename T, typename Map, typename Reduce>
+    T parallelReduce(size_t count, T identity, Map&& map, Reduce&& reduce, size_t grain = 0)
     {
         if (!count)
-            return;
-        size_t length = count / threads.size();
-        size_t remain = count % threads.size();
-        size_t index = 0u;
-        for (size_t i = 0u; i < threads.size(); ++i)
-        {
-            size_t invocations = length + (i < remain);
-            if (invocations)
+            return identity;
+        grain = grain ? grain : getDefaultGrain(count);
+        size_t blocks = (count + grain - 1) / grain;
+        std::vector<T> partials(blocks, identity);
+        parallelFor(blocks, [&](size_t block)
             {
-                submit([invocations, index, func] {
-                    for (size_t i = 0u; i < invocations; ++i)
-                        func(index + i);
-                    });
-                index += invocations;
-            }
+                size_t end = std::min((block + 1) * grain, count);
+                T partial = identity;
+                for (size_t i = block * grain; i < end; ++i)
+                    partial = reduce(std::move(partial), map(i));
+                partials[block] = std::move(partial);
+            });
+
+        T result = std::move(identity);
+        for (auto& partial : partials)
+            result = reduce(std::move(result), std::move(partial));
+        return result;
+    }
+
+    // output[i] = op(...op(init, input[0])..., input[i - 1]), output may alias input
+    // @return total of all inputs (what output[count] would be)
+    template<std::ranges::random_access_range In, std::ranges::random_access_range Out, typename T = std::ranges::range_value_t<In>, typename Op = std::plus<>>
+    T parallelExclusiveScan(const In& input, Out&& output, T init = T(), Op op = {}, size_t grain = 0)
+    {
+        size_t count = std::ranges::size(input);
+        if (!count)
+            return init;
+        grain = grain ? grain : getDefaultGrain(count);
+        size_t blocks = (count + grain - 1) / grain;
+
+        // Sum blocks, scan the block sums serially, then scan every block again starting from its offset
+        std::vector<std::optional<T>> block_sums(blocks);
+        parallelFor(blocks, [&](size_t block)
+            {
+                size_t begin = block * grain;
+                size_t end = std::min(begin + grain, count);
+                T sum = input[begin];
+                for (size_t i = begin + 1; i < end; ++i)
+                    sum = op(std::move(sum), input[i]);
+                block_sums[block] = std::move(sum);
+            });
+
+        std::vector<T> block_offsets;
+        block_offsets.reserve(blocks);
+        T total = std::move(init);
+        for (auto& sum : block_sums)
+        {
+            block_offsets.emplace_back(total);
+            total = op(std::move(total), std::move(*sum));
         }
+
+        parallelFor(blocks, [&](size_t block)
+            {
+                size_t end = std::min((block + 1) * grain, count);
+                T running = block_offsets[block];
+                for (size_t i = block * grain; i < end; ++i)
+                {
+                    T value = input[i];
+                    output[i] = running;
+                    running = op(std::move(running), std::move(value));
+                }
+            });
+        return total;
     }
 
+    // Helps executing tasks on the calling thread until all submitted tasks are finished
     void wait();
+    // Helps executing tasks on the calling thread until counter reaches zero
+    void wait(const JobCounter& counter);
+    void wait(const JobHandle& job);
     size_t runningTasks() const { return running_tasks; }
     size_t size() const { return threads.size(); }
 
 private:
-    void work();
+    // About 8 chunks per thread, enough to even out imbalance without making chunk grabbing contended
+    size_t getDefaultGrain(size_t count) const { return std::max(count / (threads.size() * 8), size_t(1)); }
+    void push(Task* task);
+    void addDependencies(const JobHandle& job, std::span<const JobHandle> dependencies);
+    static void release(Job& job);
+    static void finish(Job& job);
+    void help(const std::atomic<size_t>& pending);
+    void help(const JobCounter& counter);
+    Task* findTask(size_t worker);
+    void execute(Task* task);
+    void work(size_t worker);
+
+private:
+    static constexpr size_t NOT_WORKER = std::numeric_limits<size_t>::max();
+    static constexpr size_t SPIN_COUNT = 64;
+
+    static inline thread_local TaskCache task_cache = {};
+    static inline thread_local ThreadPool* current_pool = nullptr;
+    static inline thread_local size_t current_worker = NOT_WORKER;
 
 private:
-    std::mutex queue_mutex;
-    std::queue<std::function<void()>> tasks;
     std::vector<std::thread> threads;
-    std::condition_variable_any condition;
+    std::vector<unique<WorkStealingDeque<Task*>>> queues;
+    WorkStealingDeque<Task*> injection_queue;
+    std::mutex injection_mutex;
     std::atomic_bool running = true;
     std::atomic<size_t> running_tasks = 0;
-};
-
+    std::atomic<uint32_t> wake_epoch = 0;
+    std::atomic<uint32_t> sleeping_workers = 0;
+};
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+// Chase-Lev deque: the owner thread pushes and pops at the bottom, any other thread steals from the top.
+// Based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Zappa Nardelli, 2013)
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class WorkStealingDeque : NoCopy
+{
+private:
+    struct Buffer
+    {
+        Buffer(int64_t capacity)
+            : capacity(capacity), mask(capacity - 1), items(new std::atomic<T>[capacity]) {}
+
+        T get(int64_t index) const { return items[index & mask].load(std::memory_order_relaxed); }
+        void put(int64_t index, T item) { items[index & mask].store(item, std::memory_order_relaxed); }
+
+        Buffer* grow(int64_t bottom, int64_t top) const
+        {
+            Buffer* buffer = new Buffer(capacity * 2);
+            for (int64_t i = top; i < bottom; ++i)
+                buffer->put(i, get(i));
+            return buffer;
+        }
+
+        int64_t capacity = 0;
+        int64_t mask = 0;
+        unique<std::atomic<T>[]> items = nullptr;
+    };
+
+public:
+    WorkStealingDeque(int64_t capacity = 1024)
+    {
+        SK_VERIFY(std::has_single_bit(uint64_t(capacity)), "Work stealing deque capacity must be a power of 2");
+        buffers.emplace_back(new Buffer(capacity));
+        buffer.store(buffers.back().get(), std::memory_order_relaxed);
+    }
+
+    // Owner only
+    void push(T item)
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1)
+        {
+            // Thieves may still read from the old buffer, so it's kept alive until the deque is destroyed
+            buffers.emplace_back(a->grow(b, t));
+            a = buffers.back().get();
+            buffer.store(a, std::memory_order_release);
+        }
+        a->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only
+    std::optional<T> pop()
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* a = buffer.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+        if (t > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        std::optional<T> item = a->get(b);
+        if (t == b)
+        {
+            // Last item, race against thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = std::nullopt;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread
+    std::optional<T> steal()
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+        if (t >= b)
+            return std::nullopt;
+
+        T item = buffer.load(std::memory_order_acquire)->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return std::nullopt;
+        return item;
+    }
+
+    bool empty() const { return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed); }
+    size_t size() const { return std::max(bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_relaxed), int64_t(0)); }
+
+private:
+    alignas(64) std::atomic<int64_t> top = 0;
+    alignas(64) std::atomic<int64_t> bottom = 0;
+    alignas(64) std::atomic<Buffer*> buffer = nullptr;
+    std::vector<unique<Buffer>> buffers = {};
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "silk_engine/core/input/input.h"
 #include "silk_engine/core/event.h"
+#include "silk_engine/core/task_scheduler.h"
 #include "silk_engine/scene/scene.h"
 #include "silk_engine/gfx/window/glfw.h"
 #include "silk_engine/gfx/window/window.h"
@@ -14,6 +15,8 @@
 #include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/gfx/pipeline/render_graph/render_graph.h"
 #include "silk_engine/gfx/pipeline/render_pass.h"
+#include "silk_engine/utils/frame_statistics.h"
+#include "silk_engine/utils/memory_tracker.h"
 
 #include "my_app.h"
 #include "my_scene.h"
@@ -23,6 +26,9 @@ MyApp::MyApp()
     GLFW::init();
     Input::init();
     RenderContext::init("MyApp");
+    MemoryTracker::setBudget(MemoryTracker::Tag::WORLD, MemoryTracker::Domain::HOST, 2048ull * 1024 * 1024);
+    MemoryTracker::setBudget(MemoryTracker::Tag::WORLD, MemoryTracker::Domain::DEVICE, 2048ull * 1024 * 1024);
+    MemoryTracker::setBudget(MemoryTracker::Tag::DEBUG_RENDERER, MemoryTracker::Domain::DEVICE, 256ull * 1024 * 1024);
 
     window = makeShared<Window>();
 
@@ -42,6 +48,7 @@ MyApp::~MyApp()
 
     scene = nullptr;
     window = nullptr;
+    TaskScheduler::destroy();
     RenderContext::destroy();
     GLFW::destroy();
     SK_INFO("Terminated");
@@ -62,6 +69,29 @@ void MyApp::onKeyPress(const KeyPressEvent& e)
     case Key::ESCAPE:
         e.window.close();
         break;
+    case Key::F3:
+        // Toggles a profiler capture, saved as a Chrome trace when stopped
+        if (Profiler::isCapturing())
+        {
+            Profiler::stop();
+            Profiler::save(std::format("res/profiles/{}.json", Time::getDateTime("%Y-%m-%d_%H-%M-%S")));
+        }
+        else Profiler::start();
+        break;
+    case Key::F4:
+        // Toggles a frame statistics run, saved as CSV and JSON when stopped
+        if (FrameStatistics::isRecording())
+        {
+            FrameStatistics::stopRun();
+            std::string file = std::format("res/frame_statistics/{}", Time::getDateTime("%Y-%m-%d_%H-%M-%S"));
+            FrameStatistics::save(file + ".csv");
+            FrameStatistics::save(file + ".json");
+        }
+        else FrameStatistics::startRun();
+        break;
+    case Key::F5:
+        MemoryTracker::report();
+        break;
     case Key::F11:
         e.window.setFullscreen(!e.window.isFullscreen());
         break;
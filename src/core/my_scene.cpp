@@ -4,6 +4,7 @@
 #include "silk_engine/utils/cooldown.h"
 #include "silk_engine/gfx/render_context.h"
 #include "silk_engine/gfx/pipeline/render_graph/render_graph.h"
+#include "silk_engine/utils/frame_statistics.h"
 
 #include "my_scene.h"
 #include "world/world.h"
@@ -18,10 +19,11 @@ void MyScene::onStart()
     color.setClearColor({ 0.0f, 0.0f, 0.0f, 0.0f });
     auto& depth = geometry.addAttachment("Depth", Format::DEPTH24_STENCIL, RenderContext::getPhysicalDevice().getMaxSampleCount());
     depth.setClearDepthStencil({ 1.0f, 0 });
+    geometry.setParallel();
     geometry.setRenderCallback([&](const RenderGraph& render_graph) 
     { 
-        world->render();
-        DebugRenderer::render(); 
+        world->render(render_graph);
+        render_graph.record([] { DebugRenderer::render(); });
     });
     render_graph->build("Color");
     RenderContext::setRenderGraph(render_graph);
@@ -38,7 +40,11 @@ void MyScene::onUpdate()
 
     static Cooldown c(100ms);
     if (c())
-        Window::get().setTitle(std::format("Vulkan - {} FPS ({:.4} ms) | {}x{}", int(1.0 / Time::dt), (Time::dt * 1000), Window::get().getWidth(), Window::get().getHeight()));
+    {
+        FrameStatistics::Summary cpu = FrameStatistics::getSummary(FrameStatistics::CPU);
+        FrameStatistics::Summary gpu = FrameStatistics::getSummary(FrameStatistics::GPU);
+        Window::get().setTitle(std::format("Vulkan - {} FPS | CPU p50 {:.2f} p99 {:.2f} ms | GPU p50 {:.2f} p99 {:.2f} ms | {}x{}", int(1.0 / Time::dt), cpu.p50, cpu.p99, gpu.p50, gpu.p99, Window::get().getWidth(), Window::get().getHeight()));
+    }
 
 
     DebugRenderer::reset();
@@ -49,8 +55,9 @@ void MyScene::onUpdate()
     DebugRenderer::text(std::string("Geometry Primitives: ") + std::to_string(stats.geometry_primitives / 1000) + "K", 16.0f, 64.0f, 24.0f);
     DebugRenderer::text(std::string("Fragment Invocations: ") + std::to_string(stats.fragment_invocations / 1000) + "K", 16.0f, 96.0f, 24.0f);
     DebugRenderer::text(std::string("Compute Invocations: ") + std::to_string(stats.compute_invocations / 1000) + "K", 16.0f, 128.0f, 24.0f);
-    render_graph->render(&stats);
+    // Uploads into this frame's buffers, which render then draws
     DebugRenderer::update(Scene::getActive()->getMainCamera());
+    render_graph->render(&stats);
 }
 
 void MyScene::onStop()
@@ -14,52 +14,32 @@ enum class Block : uint32_t
 	SNOW,
 
 	LAST,
-	ANY,
+	// Blocks registered at runtime come after LAST, so ANY and NONE are kept at the top of the range
+	ANY = std::numeric_limits<std::underlying_type_t<Block>>::max() - 1,
 	NONE = std::numeric_limits<std::underlying_type_t<Block>>::max()
 };
 static constexpr size_t TOTAL_BLOCKS = ecast(Block::LAST);
 
-static constexpr const char* BLOCK_NAMES[TOTAL_BLOCKS]
+struct BlockDefinition
 {
-	"AIR",
-	"STONE",
-	"GRASS",
-	"DIRT",
-	"SAND",
-	"SANDSTONE",
-	"WATER",
-	"LEAF",
-	"OAK_LOG",
-	"SNOW"
+	std::string_view name = "";
+	bool solid = false;
+	std::array<uint8_t, 6> textures = {}; // Indices into BLOCK_TEXTURES, per face: Y-, Z-, X-, X+, Z+, Y+
 };
 
-// SOLID
-static constexpr bool BLOCK_SOLID[TOTAL_BLOCKS]
+// Built-in blocks, BlockRegistry packs these into lookup tables at compile time
+static constexpr BlockDefinition BLOCK_DEFINITIONS[TOTAL_BLOCKS]
 {
-	/* AIR		 */  0,
-	/* STONE	 */  1,
-	/* GRASS	 */  1,
-	/* DIRT		 */  1,
-	/* SAND		 */  1,
-	/* SANDSTONE */  1,
-	/* WATER	 */  0,
-	/* LEAF		 */  0,
-	/* OAK_LOG	 */  1,
-	/* SNOW		 */  1
-};
-
-static constexpr uint32_t BLOCK_TEXTURE_INDICES[TOTAL_BLOCKS * 6]
-{
-	/* AIR		 */  0, 0, 0, 0, 0, 0,
-	/* STONE	 */  1, 1, 1, 1, 1, 1,
-	/* GRASS	 */  4, 3, 3, 3, 3, 2,
-	/* DIRT		 */  4, 4, 4, 4, 4, 4,
-	/* SAND		 */  5, 5, 5, 5, 5, 5,
-	/* SANDSTONE */  6, 6, 6, 6, 6, 7,
-	/* WATER	 */  8, 8, 8, 8, 8, 8,
-	/* LEAF		 */  9, 9, 9, 9, 9, 9,
-	/* OAK_LOG	 */  11, 10, 10, 10, 10, 11,
-	/* SNOW		 */  12, 12, 12, 12, 12, 12
+	{ "AIR",		false, {  0,  0,  0,  0,  0,  0 } },
+	{ "STONE",		true,  {  1,  1,  1,  1,  1,  1 } },
+	{ "GRASS",		true,  {  4,  3,  3,  3,  3,  2 } },
+	{ "DIRT",		true,  {  4,  4,  4,  4,  4,  4 } },
+	{ "SAND",		true,  {  5,  5,  5,  5,  5,  5 } },
+	{ "SANDSTONE",	true,  {  6,  6,  6,  6,  6,  7 } },
+	{ "WATER",		false, {  8,  8,  8,  8,  8,  8 } },
+	{ "LEAF",		false, {  9,  9,  9,  9,  9,  9 } },
+	{ "OAK_LOG",	true,  { 11, 10, 10, 10, 10, 11 } },
+	{ "SNOW",		true,  { 12, 12, 12, 12, 12, 12 } }
 };
 
 static inline const auto BLOCK_TEXTURES = makeArray<fs::path>
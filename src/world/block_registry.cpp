@@ -0,0 +1,120 @@
+#include "block_registry.h"
+#include "silk_engine/io/file.h"
+
+Block BlockRegistry::find(std::string_view name)
+{
+	for (size_t i = 0; i < names.size(); ++i)
+		if (names[i] == name)
+			return Block(i);
+	return Block::NONE;
+}
+
+Block BlockRegistry::add(std::string_view name, bool solid, const std::array<fs::path, BLOCK_FACES>& face_textures)
+{
+	if (Block existing = find(name); existing != Block::NONE)
+	{
+		SK_WARN("Block {} is already registered", name);
+		return existing;
+	}
+	if (names.size() >= MAX_BLOCKS)
+	{
+		SK_ERROR("Couldn't register block {}, block limit of {} reached", name, MAX_BLOCKS);
+		return Block::NONE;
+	}
+
+	size_t id = names.size();
+	std::array<uint8_t, BLOCK_FACES> texture_indices{};
+	for (size_t face = 0; face < BLOCK_FACES; ++face)
+	{
+		if (textures.size() >= MAX_BLOCK_TEXTURES && std::ranges::find(textures, face_textures[face]) == textures.end())
+		{
+			SK_ERROR("Couldn't register block {}, texture limit of {} reached", name, MAX_BLOCK_TEXTURES);
+			return Block::NONE;
+		}
+		texture_indices[face] = addTexture(face_textures[face]);
+	}
+
+	names.emplace_back(name);
+	tables.solid[id >> 6] |= uint64_t(solid) << (id & 63);
+	std::ranges::copy(texture_indices, tables.textures[id].begin());
+	return Block(id);
+}
+
+bool BlockRegistry::load(const fs::path& file)
+{
+	if (!File::exists(file))
+	{
+		SK_ERROR("Couldn't find block data file: {}", file);
+		return false;
+	}
+
+	std::istringstream data(File::read(file));
+	std::string line;
+	size_t line_number = 0;
+	bool success = true;
+	while (std::getline(data, line))
+	{
+		++line_number;
+		std::istringstream line_stream(line);
+		std::string name;
+		if (!(line_stream >> name) || name.starts_with('#'))
+			continue;
+
+		int solid = 0;
+		line_stream >> solid;
+		std::vector<fs::path> files;
+		for (std::string texture; line_stream >> texture;)
+			files.emplace_back(texture);
+
+		std::array<fs::path, BLOCK_FACES> face_textures;
+		switch (files.size())
+		{
+		case 1:
+			face_textures.fill(files[0]);
+			break;
+		case 3:
+			face_textures = { files[0], files[1], files[1], files[1], files[1], files[2] };
+			break;
+		case BLOCK_FACES:
+			std::ranges::copy(files, face_textures.begin());
+			break;
+		default:
+			SK_ERROR("{}:{}: Block {} has {} textures, expected 1, 3 or {}", file, line_number, name, files.size(), BLOCK_FACES);
+			success = false;
+			continue;
+		}
+		success &= add(name, solid, face_textures) != Block::NONE;
+	}
+	return success;
+}
+
+Shader::Defines BlockRegistry::getDefines()
+{
+	Shader::Defines defines{};
+	defines.emplace_back("TOTAL_BLOCKS", std::to_string(names.size()));
+	for (size_t i = 0; i < names.size(); ++i)
+		defines.emplace_back(names[i], std::to_string(i));
+	defines.emplace_back("ANY", std::to_string(ecast(Block::ANY)));
+	defines.emplace_back("NONE", std::to_string(ecast(Block::NONE)));
+
+	// GLSL has no 64 bit integers without extensions, so solid bits are split in 32 bit words
+	std::string solid = "uint[](";
+	for (size_t word = 0; word < (names.size() + 31) / 32; ++word)
+		solid += std::format("{}{}u", word ? ", " : "", uint32_t(tables.solid[word >> 1] >> ((word & 1) * 32)));
+	defines.emplace_back("BLOCK_SOLID", solid + ")");
+
+	std::string face_textures = "uint[](";
+	for (size_t i = 0; i < names.size(); ++i)
+		for (size_t face = 0; face < BLOCK_FACES; ++face)
+			face_textures += std::format("{}{}u", (i || face) ? ", " : "", uint32_t(tables.textures[i][face]));
+	defines.emplace_back("BLOCK_TEXTURES", face_textures + ")");
+	return defines;
+}
+
+uint8_t BlockRegistry::addTexture(const fs::path& file)
+{
+	if (auto it = std::ranges::find(textures, file); it != textures.end())
+		return uint8_t(it - textures.begin());
+	textures.emplace_back(file);
+	return uint8_t(textures.size() - 1);
+}
\ No newline at end of file
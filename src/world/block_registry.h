@@ -0,0 +1,80 @@
+#pragma once
+
+#include "block.h"
+#include "silk_engine/gfx/pipeline/shader.h"
+
+static constexpr size_t MAX_BLOCKS = 256;
+static constexpr size_t MAX_BLOCK_TEXTURES = 256; // Texture index is packed in 8 bits of Chunk::Vertex
+static constexpr size_t BLOCK_FACES = 6;
+
+// All per block properties the mesher touches, packed in a single cache aligned table
+struct alignas(64) BlockTables
+{
+	std::array<uint64_t, MAX_BLOCKS / 64> solid = {};
+	std::array<std::array<uint8_t, 8>, MAX_BLOCKS> textures = {}; // 6 faces padded to 8 bytes
+};
+
+static constexpr BlockTables BUILTIN_BLOCK_TABLES = []
+{
+	BlockTables tables{};
+	for (size_t i = 0; i < TOTAL_BLOCKS; ++i)
+	{
+		const BlockDefinition& definition = BLOCK_DEFINITIONS[i];
+		tables.solid[i >> 6] |= uint64_t(definition.solid) << (i & 63);
+		for (size_t face = 0; face < BLOCK_FACES; ++face)
+			tables.textures[i][face] = definition.textures[face];
+	}
+	return tables;
+}();
+
+static_assert(TOTAL_BLOCKS <= MAX_BLOCKS, "Too many built-in blocks");
+static_assert(!(BUILTIN_BLOCK_TABLES.solid[0] & 1), "AIR can't be solid");
+
+// Built-in blocks come from the compile time tables, more blocks can be registered at startup
+// from a data file (before chunks are generated and chunk shaders are compiled)
+class BlockRegistry
+{
+public:
+	// ANY and NONE (and anything else past the tables) aren't solid and use texture 0
+	static bool isSolid(Block block)
+	{
+		uint32_t id = ecast(block);
+		return id < MAX_BLOCKS && ((tables.solid[id >> 6] >> (id & 63)) & 1);
+	}
+	static uint32_t getTexture(Block block, size_t face)
+	{
+		uint32_t id = ecast(block);
+		return id < MAX_BLOCKS ? tables.textures[id][face] : 0;
+	}
+	static size_t getCount() { return names.size(); }
+	static std::string_view getName(Block block) { return names[ecast(block)]; }
+	static const std::vector<fs::path>& getTextures() { return textures; }
+	static const BlockTables& getTables() { return tables; }
+	static Block find(std::string_view name);
+
+	// @param face_textures texture files per face: Y-, Z-, X-, X+, Z+, Y+
+	static Block add(std::string_view name, bool solid, const std::array<fs::path, BLOCK_FACES>& face_textures);
+
+	// Each non empty line that doesn't start with '#' describes a block:
+	// NAME SOLID(0/1) TEXTURE              - same texture on all faces
+	// NAME SOLID(0/1) BOTTOM SIDE TOP      - separate bottom, side and top textures
+	// NAME SOLID(0/1) Y- Z- X- X+ Z+ Y+    - texture per face
+	static bool load(const fs::path& file);
+
+	// Block ids by name, TOTAL_BLOCKS, ANY, NONE and the BLOCK_SOLID/BLOCK_TEXTURES tables for chunk shaders
+	static Shader::Defines getDefines();
+
+private:
+	static uint8_t addTexture(const fs::path& file);
+
+private:
+	static inline BlockTables tables = BUILTIN_BLOCK_TABLES;
+	static inline std::vector<std::string> names = []
+	{
+		std::vector<std::string> builtin_names;
+		for (const auto& definition : BLOCK_DEFINITIONS)
+			builtin_names.emplace_back(definition.name);
+		return builtin_names;
+	}();
+	static inline std::vector<fs::path> textures = std::vector<fs::path>(BLOCK_TEXTURES.begin(), BLOCK_TEXTURES.end());
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "chunk.h"
+#include "chunk_vertex_pool.h"
 #include "silk_engine/gfx/render_context.h"
 #include "silk_engine/gfx/buffers/buffer.h"
 #include "silk_engine/gfx/pipeline/shader.h"
@@ -7,8 +8,10 @@
 #include "silk_engine/gfx/pipeline/material.h"
 #include "silk_engine/utils/random.h"
 #include "silk_engine/utils/debug_timer.h"
+#include "silk_engine/utils/memory_tracker.h"
 #include "silk_engine/gfx/descriptors/descriptor_set.h"
 #include "world.h"
+#include "block_registry.h"
 
 Chunk::~Chunk()
 {
@@ -20,6 +23,8 @@ Chunk::~Chunk()
             neighbor->dirty = true;
         }
     }
+    if (vertex_pool)
+        vertex_pool->free(vertex_range);
 }
 
 void Chunk::generateStart()
@@ -27,7 +32,7 @@ void Chunk::generateStart()
     fill = Block::ANY;
     block_buffer = makeShared<Buffer>(SHARED_VOLUME * sizeof(Block) + sizeof(fill), BufferUsage::STORAGE, Allocation::Props{ Allocation::RANDOM_ACCESS | Allocation::MAPPED });
     block_buffer->setData(&fill, sizeof(fill));
-    auto gen_material = makeShared<Material>(ComputePipeline::get("Chunk Gen"));
+    auto gen_material = makeShared<Material>(ComputePipeline::get("Chunk Gen"_id));
     gen_material->set("Blocks", *block_buffer);
     gen_material->bind();
     RenderContext::getCommandBuffer().pushConstants(ShaderStage::COMPUTE, 0, sizeof(position), &position);
@@ -51,12 +56,17 @@ void Chunk::generateEnd()
     block_buffer = nullptr;
 }
 
-void Chunk::generateMesh()
+void Chunk::generateMesh(ChunkVertexPool& vertex_pool, ChunkMeshCache* mesh_cache)
 {
     if (!dirty)
         return;
+    SK_PROFILE_FUNCTION();
+    MemoryTracker::Scope memory_scope(MemoryTracker::Tag::WORLD); // Runs on worker threads
     dirty = false;
     vertex_count = 0;
+    // Frames in flight may still draw the old mesh, the pool only reuses its range once they're done
+    this->vertex_pool = &vertex_pool;
+    vertex_pool.free(std::exchange(vertex_range, {}));
     if (blocks.size() != SHARED_VOLUME)
         return;
 
@@ -64,6 +74,28 @@ void Chunk::generateMesh()
         updateNeighboringBlocks(i);
 
     thread_local std::vector<Vertex> vertices(MAX_VERTICES);
+    // Blocks include the halo, so identical hashes produce identical meshes
+    ChunkMeshCache::Key mesh_key = mesh_cache ? ChunkMeshCache::hash(blocks) : ChunkMeshCache::Key{};
+    if (!mesh_cache || !mesh_cache->get(mesh_key, vertices.data(), vertex_count))
+    {
+        vertex_count = buildMesh(vertices);
+        if (mesh_cache)
+            mesh_cache->put(mesh_key, vertices.data(), vertex_count);
+    }
+
+    if (!vertex_count)
+        return;
+    vertex_range = vertex_pool.allocate(std::span<const Vertex>(vertices.data(), vertex_count));
+    if (!vertex_range)
+    {
+        SK_WARN("Chunk vertex pool is full, chunk isn't drawn");
+        vertex_count = 0;
+    }
+}
+
+uint32_t Chunk::buildMesh(std::vector<Vertex>& vertices) const
+{
+    uint32_t vertex_count = 0;
     thread_local std::vector<bool> visited(SHARED_VOLUME * 6);
     visited.assign(visited.size(), 0);
     constexpr int32_t axis[6] = { -SHARED_AREA, -SHARED_SIZE, -1, 1, SHARED_SIZE, SHARED_AREA };
@@ -80,12 +112,12 @@ void Chunk::generateMesh()
             
                 for (size_t face = 0; face < 6; ++face)
                 {
-                    if (BLOCK_SOLID[ecast(blocks[i + axis[face]])] || visited[i * 6 + face])
+                    if (BlockRegistry::isSolid(blocks[i + axis[face]]) || visited[i * 6 + face])
                         continue;
                     Vertex run_x = 1; 
                     for (; run_x < SIZE - x; ++run_x)
                     {
-                        if (BLOCK_SOLID[ecast(blocks[i + run_x * greedy_axis[face] + axis[face]])])
+                        if (BlockRegistry::isSolid(blocks[i + run_x * greedy_axis[face] + axis[face]]))
                             break;
                         size_t ni = i + run_x * greedy_axis[face];
                         Block neighbor = blocks[ni];
@@ -94,7 +126,7 @@ void Chunk::generateMesh()
                         visited[ni * 6 + face] = true;
                     }
             
-                    Vertex face_data = (face << 2) | (Vertex(y * AREA + z * SIZE + x) << 5) | (Vertex(BLOCK_TEXTURE_INDICES[size_t(blocks[i]) * 6 + face]) << 23) | ((run_x - Vertex(1)) << 34);
+                    Vertex face_data = (face << 2) | (Vertex(y * AREA + z * SIZE + x) << 5) | (Vertex(BlockRegistry::getTexture(blocks[i], face)) << 23) | ((run_x - Vertex(1)) << 34);
 
                     vertices[vertex_count++] = 2 | face_data;
                     vertices[vertex_count++] = 1 | face_data;
@@ -106,26 +138,15 @@ void Chunk::generateMesh()
             }
         }
     }
-
-    if (vertex_count)
-    {
-        size_t vertices_size = vertex_count * sizeof(Vertex);
-        if (!vertex_buffer || vertices_size != vertex_buffer->getSize())
-            vertex_buffer = makeShared<Buffer>(vertices_size, BufferUsage::VERTEX | BufferUsage::TRANSFER_DST);
-        static std::mutex mux;
-        std::scoped_lock lock(mux);
-        vertex_buffer->setData(vertices.data());
-    }
-    else vertex_buffer = nullptr;
+    return vertex_count;
 }
 
 void Chunk::render() const
 {
-    if (!vertex_buffer)
+    if (!vertex_count)
         return;
     RenderContext::getCommandBuffer().pushConstants(ShaderStage::VERTEX, 0, sizeof(position), &position);
-    vertex_buffer->bindVertex();
-    RenderContext::getCommandBuffer().draw(vertex_count);
+    RenderContext::getCommandBuffer().draw(vertex_count, 1, uint32_t(vertex_range.offset));
 }
 
 void Chunk::updateNeighboringBlocks(size_t index)
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "block.h"
+#include "silk_engine/utils/linear_arena.h"
+#include "silk_engine/utils/offset_allocator.h"
 
 class Buffer;
+class ChunkMeshCache;
+class ChunkVertexPool;
 
 class Chunk : NoCopy
 {
@@ -72,7 +76,8 @@ public:
 
 	void generateStart();
 	void generateEnd();
-	void generateMesh();
+	void generateMesh(ChunkVertexPool& vertex_pool, ChunkMeshCache* mesh_cache = nullptr);
+	// Expects vertex_pool to be bound
 	void render() const;
 
 	void addNeighbor(size_t index, Chunk* neighbor)
@@ -85,9 +90,10 @@ public:
 		neighbor->addNeighbor(getNeighborIndexFromCoord(position - neighbor->getPosition()), this);
 	}
 
-	std::vector<Chunk::Coord> getMissingAdjacentNeighborLocations() const
+	ArenaVector<Chunk::Coord> getMissingAdjacentNeighborLocations(LinearArena& arena) const
 	{
-		std::vector<Chunk::Coord> missing_neighbors;
+		ArenaVector<Chunk::Coord> missing_neighbors(arena);
+		missing_neighbors.reserve(6);
 		for (size_t i = 0; i < 6; ++i)
 			if (!neighbors[getNeighborIndexFromCoord(ADJACENT_NEIGHBORS[i])])
 				missing_neighbors.emplace_back(ADJACENT_NEIGHBORS[i]);
@@ -97,7 +103,6 @@ public:
 	Block& at(uint32_t x, uint32_t y, uint32_t z) { return blocks.size() ? blocks[idx(x, y, z)] : fill; }
 	Block at(uint32_t x, uint32_t y, uint32_t z) const { return blocks.size() ? blocks[idx(x, y, z)] : fill; }
 	const Coord& getPosition() const { return position; }
-	const shared<Buffer>& getVertexBuffer() const { return vertex_buffer; }
 	uint32_t getVertexCount() const { return vertex_count; }
 	Block getFill() const { return fill; }
 
@@ -106,6 +111,7 @@ public:
 
 private:
 	void updateNeighboringBlocks(size_t index);
+	uint32_t buildMesh(std::vector<Vertex>& vertices) const;
 
 public:
 	static size_t idx(uint32_t x, uint32_t y, uint32_t z) { return (y + 1) * SHARED_AREA + (z + 1) * SHARED_SIZE + (x + 1); }
@@ -140,7 +146,8 @@ private:
 	Coord position = Coord(0);
 	std::vector<Block> blocks = {};
 	uint32_t vertex_count = 0;
-	shared<Buffer> vertex_buffer = nullptr;
+	OffsetAllocator::Range vertex_range = {};
+	ChunkVertexPool* vertex_pool = nullptr;
 	shared<Buffer> block_buffer = nullptr;
 	std::array<Chunk*, 26> neighbors = {};
 	bool dirty = true;
@@ -0,0 +1,139 @@
+#include "chunk_mesh_cache.h"
+#include "silk_engine/io/file.h"
+#include "block_registry.h"
+#include "silk_engine/utils/hash.h"
+
+ChunkMeshCache::~ChunkMeshCache()
+{
+	if (!persistent)
+		return;
+	for (const auto& entry : entries)
+		save(entry);
+}
+
+bool ChunkMeshCache::get(Key key, Chunk::Vertex* vertices, uint32_t& vertex_count)
+{
+	std::scoped_lock lock(mux);
+	if (auto it = lookup.find(key.hash); it != lookup.end())
+	{
+		// Same hash for different blocks, the cached mesh belongs to the other chunk
+		if (it->second->key != key)
+		{
+			++misses;
+			return false;
+		}
+		entries.splice(entries.begin(), entries, it->second);
+		const auto& cached = it->second->vertices;
+		std::ranges::copy(cached, vertices);
+		vertex_count = uint32_t(cached.size());
+		++hits;
+		return true;
+	}
+
+	std::vector<Chunk::Vertex> loaded;
+	if (persistent && load(key, loaded))
+	{
+		std::ranges::copy(loaded, vertices);
+		vertex_count = uint32_t(loaded.size());
+		insert(key, std::move(loaded));
+		++hits;
+		return true;
+	}
+
+	++misses;
+	return false;
+}
+
+void ChunkMeshCache::put(Key key, const Chunk::Vertex* vertices, uint32_t vertex_count)
+{
+	std::scoped_lock lock(mux);
+	if (lookup.contains(key.hash))
+		return;
+	insert(key, std::vector<Chunk::Vertex>(vertices, vertices + vertex_count));
+}
+
+void ChunkMeshCache::clear()
+{
+	std::scoped_lock lock(mux);
+	entries.clear();
+	lookup.clear();
+	size = 0;
+}
+
+ChunkMeshCache::Key ChunkMeshCache::hash(std::span<const Block> blocks)
+{
+	// A changed blocks file changes every key, so meshes with stale texture indices are never found
+	const BlockTables& tables = BlockRegistry::getTables();
+	uint64_t registry = Hash::combine(Hash::value(tables.solid), Hash::value(tables.textures));
+	return Key{ Hash::span(blocks, registry), Hash::span(blocks, ~registry) };
+}
+
+void ChunkMeshCache::insert(Key key, std::vector<Chunk::Vertex>&& vertices)
+{
+	size += vertices.size() * sizeof(Chunk::Vertex);
+	entries.emplace_front(key, std::move(vertices));
+	lookup.emplace(key.hash, entries.begin());
+	evict();
+}
+
+void ChunkMeshCache::evict()
+{
+	// Always keep the most recently used entry, even if it alone exceeds the budget
+	while (size > max_bytes && entries.size() > 1)
+	{
+		const Entry& entry = entries.back();
+		if (persistent)
+			save(entry);
+		size -= entry.vertices.size() * sizeof(Chunk::Vertex);
+		lookup.erase(entry.key.hash);
+		entries.pop_back();
+	}
+}
+
+bool ChunkMeshCache::load(Key key, std::vector<Chunk::Vertex>& vertices) const
+{
+	fs::path path = getCachePath(key);
+	if (!File::exists(path))
+		return false;
+
+	std::vector<uint8_t> data;
+	File::read(path, data, std::ios::binary);
+	FileHeader header{};
+	if (data.size() < sizeof(FileHeader))
+		return false;
+	memcpy(&header, data.data(), sizeof(FileHeader));
+	if (header.magic == FILE_MAGIC && header.version == FILE_VERSION && header.key.hash == key.hash && header.key.check != key.check)
+		return false; // Collision, the file holds another chunk's mesh
+	if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.key != key ||
+		header.vertex_count > Chunk::MAX_VERTICES || data.size() != sizeof(FileHeader) + header.vertex_count * sizeof(Chunk::Vertex))
+	{
+		SK_WARN("Chunk mesh cache file is invalid: {}", path);
+		return false;
+	}
+
+	vertices.resize(header.vertex_count);
+	memcpy(vertices.data(), data.data() + sizeof(FileHeader), vertices.size() * sizeof(Chunk::Vertex));
+	return true;
+}
+
+void ChunkMeshCache::save(const Entry& entry) const
+{
+	fs::path path = getCachePath(entry.key);
+	if (File::exists(path))
+		return;
+	if (!fs::exists(File::directory(path)))
+		fs::create_directories(File::directory(path));
+
+	FileHeader header{};
+	header.key = entry.key;
+	header.vertex_count = entry.vertices.size();
+	std::vector<uint8_t> data(sizeof(FileHeader) + entry.vertices.size() * sizeof(Chunk::Vertex));
+	memcpy(data.data(), &header, sizeof(FileHeader));
+	memcpy(data.data() + sizeof(FileHeader), entry.vertices.data(), entry.vertices.size() * sizeof(Chunk::Vertex));
+	File::write(path, data.data(), data.size(), std::ios::binary | std::ios::trunc);
+}
+
+fs::path ChunkMeshCache::getCachePath(Key key)
+{
+	return fs::path("res/cache/chunks") / std::format("{:016x}.mesh", key.hash);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <list>
+#include "chunk.h"
+
+// Caches built chunk meshes keyed by a hash of the chunk's blocks (including the shared halo),
+// so chunks that get destroyed and regenerated with identical contents don't have to be meshed again
+class ChunkMeshCache : NoCopy
+{
+public:
+	// Both hashes are seeded with the block registry tables, vertices hold its texture indices
+	struct Key
+	{
+		uint64_t hash = 0;
+		uint64_t check = 0; // Independent second hash, a hit whose check differs is a collision and misses
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	static constexpr uint32_t FILE_MAGIC = 0x484D4B43; // "CKMH"
+	static constexpr uint32_t FILE_VERSION = 3; // 2: keys are wyhash, 3: keys have a check hash and include the block registry
+
+private:
+	struct Entry
+	{
+		Key key = 0;
+		std::vector<Chunk::Vertex> vertices = {};
+	};
+
+	struct FileHeader
+	{
+		uint32_t magic = FILE_MAGIC;
+		uint32_t version = FILE_VERSION;
+		Key key = 0;
+		uint64_t vertex_count = 0;
+	};
+
+public:
+	// @param max_bytes memory bound of cached vertices, least recently used meshes get evicted past it
+	// @param persistent evicted (and on destruction, all) meshes are saved to disk and loaded back on a miss
+	ChunkMeshCache(size_t max_bytes = 256 * 1024 * 1024, bool persistent = false)
+		: max_bytes(max_bytes), persistent(persistent) {}
+	~ChunkMeshCache();
+
+	// Copies cached vertices (if any) into vertices, which should be able to hold Chunk::MAX_VERTICES
+	bool get(Key key, Chunk::Vertex* vertices, uint32_t& vertex_count);
+	void put(Key key, const Chunk::Vertex* vertices, uint32_t vertex_count);
+	void clear();
+
+	size_t getSize() const { return size; }
+	size_t getCount() const { return entries.size(); }
+	size_t getHits() const { return hits; }
+	size_t getMisses() const { return misses; }
+
+public:
+	static Key hash(std::span<const Block> blocks);
+
+private:
+	void insert(Key key, std::vector<Chunk::Vertex>&& vertices);
+	void evict();
+	bool load(Key key, std::vector<Chunk::Vertex>& vertices) const;
+	void save(const Entry& entry) const;
+
+	static fs::path getCachePath(Key key);
+
+private:
+	std::list<Entry> entries = {}; // Front is most recently used
+	std::unordered_map<uint64_t, std::list<Entry>::iterator> lookup = {}; // By Key::hash
+	size_t size = 0;
+	size_t max_bytes = 0;
+	bool persistent = false;
+	size_t hits = 0;
+	size_t misses = 0;
+	mutable std::mutex mux;
+};
\ No newline at end of file
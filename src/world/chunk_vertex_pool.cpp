@@ -0,0 +1,49 @@
+#include "chunk_vertex_pool.h"
+#include "silk_engine/gfx/render_context.h"
+#include "silk_engine/gfx/buffers/buffer.h"
+
+ChunkVertexPool::ChunkVertexPool(size_t vertex_capacity)
+	: buffer(makeShared<Buffer>(vertex_capacity * sizeof(Chunk::Vertex), BufferUsage::VERTEX | BufferUsage::TRANSFER_DST)), allocator(vertex_capacity)
+{
+}
+
+OffsetAllocator::Range ChunkVertexPool::allocate(std::span<const Chunk::Vertex> vertices)
+{
+	std::scoped_lock lock(mux);
+	reclaim();
+	OffsetAllocator::Range range = allocator.allocate(vertices.size());
+	if (range)
+		buffer->setData(vertices.data(), vertices.size_bytes(), range.offset * sizeof(Chunk::Vertex));
+	return range;
+}
+
+void ChunkVertexPool::free(OffsetAllocator::Range range)
+{
+	if (!range)
+		return;
+	std::scoped_lock lock(mux);
+	retired.emplace_back(RenderContext::getFrameNumber(), range);
+}
+
+void ChunkVertexPool::bind() const
+{
+	buffer->bindVertex();
+}
+
+OffsetAllocator::Statistics ChunkVertexPool::getStatistics() const
+{
+	std::scoped_lock lock(mux);
+	return allocator.getStatistics();
+}
+
+void ChunkVertexPool::reclaim()
+{
+	uint64_t finished_frames = RenderContext::getFinishedFrames();
+	std::erase_if(retired, [&](const auto& retired_range)
+		{
+			if (retired_range.first >= finished_frames)
+				return false;
+			allocator.free(retired_range.second);
+			return true;
+		});
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "chunk.h"
+#include "silk_engine/utils/offset_allocator.h"
+
+// One big vertex buffer every chunk mesh is suballocated from, instead of a buffer per chunk.
+// Offsets are in vertices, so a range's offset is the first vertex to draw it with
+class ChunkVertexPool : NoCopy
+{
+public:
+	ChunkVertexPool(size_t vertex_capacity);
+
+	// Uploads vertices into a free range
+	// @return invalid range if the pool is full
+	OffsetAllocator::Range allocate(std::span<const Chunk::Vertex> vertices);
+	// The range is only reused once the frames in flight that may still draw it finished
+	void free(OffsetAllocator::Range range);
+
+	void bind() const;
+
+	OffsetAllocator::Statistics getStatistics() const;
+
+private:
+	void reclaim();
+
+private:
+	shared<Buffer> buffer = nullptr;
+	OffsetAllocator allocator;
+	std::vector<std::pair<uint64_t, OffsetAllocator::Range>> retired = {}; // Frame number they were freed in
+	mutable std::mutex mux;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "world.h"
+#include "block_registry.h"
 #include "silk_engine/gfx/pipeline/material.h"
 #include "silk_engine/gfx/pipeline/graphics_pipeline.h"
 #include "silk_engine/gfx/pipeline/compute_pipeline.h"
@@ -6,20 +7,26 @@
 #include "silk_engine/gfx/pipeline/render_graph/render_graph.h"
 #include "silk_engine/gfx/pipeline/render_pass.h"
 #include "silk_engine/gfx/debug/debug_renderer.h"
-#include "silk_engine/gfx/devices/logical_device.h"
 #include "silk_engine/scene/camera/camera_controller.h"
 #include "silk_engine/scene/camera/camera.h"
 #include "silk_engine/scene/components.h"
-#include "silk_engine/utils/debug_timer.h"
 #include "silk_engine/gfx/window/window.h"
+#include "silk_engine/io/file.h"
+#include "silk_engine/utils/memory_tracker.h"
+#include "silk_engine/utils/thread_pool.h"
 
 World::World()
 {
+	MemoryTracker::Scope memory_scope(MemoryTracker::Tag::WORLD);
 	player = Scene::getActive()->createEntity();
 	player->add<CameraComponent>();
 	player->add<ScriptComponent>().bind<CameraController>();
 	player->get<CameraComponent>().camera.position = vec3(0.0f, 8.0f, 8.0f);
 	camera = &player->get<CameraComponent>().camera;
+	vertex_pool = makeUnique<ChunkVertexPool>(VERTEX_POOL_BYTES / sizeof(Chunk::Vertex));
+
+	if (File::exists(BLOCK_DATA_FILE))
+		BlockRegistry::load(BLOCK_DATA_FILE);
 
 	Shader::Defines chunk_defines{};
 	chunk_defines.emplace_back("SIZE", std::to_string(Chunk::SIZE));
@@ -32,11 +39,8 @@ World::World()
 	chunk_defines.emplace_back("SHARED_AREA", std::to_string(Chunk::SHARED_AREA));
 	chunk_defines.emplace_back("SHARED_VOLUME", std::to_string(Chunk::SHARED_VOLUME));
 	chunk_defines.emplace_back("SHARED_DIM", std::format("ivec3({}, {}, {})", std::to_string(Chunk::SHARED_DIM.x), std::to_string(Chunk::SHARED_DIM.y), std::to_string(Chunk::SHARED_DIM.z)));
-	chunk_defines.emplace_back("TOTAL_BLOCKS", std::to_string(TOTAL_BLOCKS));
-	for (size_t i = 0; i < TOTAL_BLOCKS; ++i)
-		chunk_defines.emplace_back(BLOCK_NAMES[i], std::to_string(i));
-	chunk_defines.emplace_back("ANY", std::to_string(uint32_t(Block::ANY)));
-	chunk_defines.emplace_back("NONE", std::to_string(uint32_t(Block::NONE)));
+	for (auto&& define : BlockRegistry::getDefines())
+		chunk_defines.emplace_back(std::move(define));
 
 	VkRenderPass render_pass = RenderContext::getRenderGraph().getPass("Geometry").getRenderPass();
 	shared<GraphicsPipeline> chunk_pipeline = makeShared<GraphicsPipeline>();
@@ -71,7 +75,7 @@ World::World()
 	props.sampler_props.u_wrap = Wrap::REPEAT;
 	props.sampler_props.v_wrap = Wrap::REPEAT;
 	props.sampler_props.anisotropy = 0.0f;
-	texture_atlas = makeShared<Image>(BLOCK_TEXTURES, props);
+	texture_atlas = makeShared<Image>(BlockRegistry::getTextures(), props);
 	texture_atlas->transitionLayout(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 	RenderContext::execute();
 
@@ -82,76 +86,115 @@ World::World()
 
 void World::update()
 {
-	static DebugTimer t1("World::update()");
-	t1.begin();
+	SK_PROFILE_FUNCTION();
+	MemoryTracker::Scope memory_scope(MemoryTracker::Tag::WORLD);
 	const vec3& origin = camera->position;
 	const Chunk::Coord& chunk_origin = Chunk::toChunkCoord((Chunk::Coord)round(origin));
 
 	// Delete far chunks
-	RenderContext::getLogicalDevice().wait();
 	constexpr float max_chunk_distance = 16;
 	constexpr float max_chunk_distance2 = max_chunk_distance * max_chunk_distance;
 	for (int32_t i = 0; i < chunks.size(); ++i)
 	{
-		if (distance2(vec3(chunks[i]->getPosition()), vec3(chunk_origin)) > max_chunk_distance2)
+		if (distance2(vec3(getChunk(chunks[i]).getPosition()), vec3(chunk_origin)) > max_chunk_distance2)
 		{
-			// TODO: When removing chunk, other chunks neighbors are made invalid, fix that
+			// Chunk's destructor unlinks it from its neighbors, stale handles to it are caught by the pool
+			chunk_lookup.erase(getChunk(chunks[i]).getPosition());
+			chunk_pool.destroy(chunks[i]);
 			std::swap(chunks[i], chunks.back());
 			chunks.pop_back();
 			--i;
 		}
 	}
 
-	static DebugTimer t2("  mesh");
-	t2.begin();
-	// Build chunks and regenerate chunks with new neighbors
-#if MULTITHREAD
-	pool.forEach(chunks.size(), [&](size_t i) {
-		chunks[i]->visible = isChunkVisible(chunks[i]->getPosition());
-		if (!chunks[i]->visible)
-			return;
-		chunks[i]->generateMesh();
-	});
-	pool.wait();
-#else
-	for (size_t i = 0; i < chunks.size(); ++i)
 	{
-		chunks[i]->visible = isChunkVisible(chunks[i]->getPosition());
-		if (!chunks[i]->visible)
-			continue;
-		chunks[i]->generateMesh();
+		SK_PROFILE_SCOPE("World::generateEnd");
+		// The device finished generating these, link them in so they're culled and meshed this frame
+		uint64_t finished_frames = RenderContext::getFinishedFrames();
+		std::erase_if(generating_chunks, [&](const GeneratingChunk& generating) {
+			if (generating.frame >= finished_frames)
+				return false;
+			Chunk& chunk = getChunk(generating.handle);
+			chunk.generateEnd();
+			chunks.emplace_back(generating.handle);
+			chunk_lookup.emplace(chunk.getPosition(), generating.handle);
+			for (size_t i = 0; i < 26; ++i)
+				chunk.addNeighbor(i, findChunk(chunk.getPosition() + Chunk::NEIGHBORS[i]));
+			return true;
+		});
 	}
-#endif
-	t2.end();
-	if (t2.getSamples() >= 64)
+
 	{
-		t2.print(t2.getAverage());
-		t2.reset();
+		SK_PROFILE_SCOPE("World::cull");
+		// Cull every chunk in one batch, visibility is reused when queueing new chunks below
+		LinearArena& arena = RenderContext::getFrameArena();
+		size_t count = chunks.size();
+		ArenaVector<float> bounds(6 * count, 0.0f, arena);
+		for (size_t i = 0; i < count; ++i)
+		{
+			vec3 min = Chunk::toWorldCoord(getChunk(chunks[i]).getPosition());
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				bounds[axis * count + i] = min[axis];
+				bounds[(3 + axis) * count + i] = min[axis] + Chunk::DIM[axis];
+			}
+		}
+		auto bound = [&](size_t index) { return std::span<const float>(bounds.data() + index * count, count); };
+		ArenaVector<uint64_t> visible(Frustum::getMaskSize(count), 0, arena);
+		camera->frustum.cull(ThreadPool::get(), Frustum::Boxes{ bound(0), bound(1), bound(2), bound(3), bound(4), bound(5) }, visible);
+		for (size_t i = 0; i < count; ++i)
+			getChunk(chunks[i]).visible = Frustum::isVisible(visible, i);
+	}
+
+	{
+		SK_PROFILE_SCOPE("World::mesh");
+		// Build chunks and regenerate chunks with new neighbors
+#if MULTITHREAD
+		// Grain of 1 chunk, meshing cost varies a lot between empty and dense chunks
+		ThreadPool::get().parallelFor(chunks.size(), [&](size_t i) {
+			Chunk& chunk = getChunk(chunks[i]);
+			if (!chunk.visible)
+				return;
+			chunk.generateMesh(*vertex_pool, &mesh_cache);
+		}, 1);
+#else
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			Chunk& chunk = getChunk(chunks[i]);
+			if (!chunk.visible)
+				continue;
+			chunk.generateMesh(*vertex_pool, &mesh_cache);
+		}
+#endif
 	}
 
 	constexpr size_t max_chunks = 4096;
-	if (chunks.size() < max_chunks)
+	if (chunks.size() + generating_chunks.size() < max_chunks)
 	{
 		// Queue up to be generated chunks
-		std::ranges::sort(chunks, [&](const shared<Chunk>& lhs, const shared<Chunk>& rhs) {
-			return ((10.0f + distance2(vec3(chunk_origin), vec3(lhs->getPosition()))) * ((lhs->getFill() != Block::NONE) * 256.0f + 1.0f)) <
-				   ((10.0f + distance2(vec3(chunk_origin), vec3(rhs->getPosition()))) * ((lhs->getFill() != Block::NONE) * 256.0f + 1.0f));
+		std::ranges::sort(chunks, [&](ChunkHandle lhs_handle, ChunkHandle rhs_handle) {
+			const Chunk& lhs = getChunk(lhs_handle);
+			const Chunk& rhs = getChunk(rhs_handle);
+			return ((10.0f + distance2(vec3(chunk_origin), vec3(lhs.getPosition()))) * ((lhs.getFill() != Block::NONE) * 256.0f + 1.0f)) <
+				   ((10.0f + distance2(vec3(chunk_origin), vec3(rhs.getPosition()))) * ((lhs.getFill() != Block::NONE) * 256.0f + 1.0f));
 		});
 
-		std::unordered_set<Chunk::Coord> queued_chunks;
-		if (!findChunk(chunk_origin))
-			queued_chunks.emplace(chunk_origin);
 		constexpr size_t max_queued_chunks = 8;
-		for (const auto& chunk : chunks)
+		using QueuedChunks = std::unordered_set<Chunk::Coord, std::hash<Chunk::Coord>, std::equal_to<Chunk::Coord>, ArenaAllocator<Chunk::Coord>>;
+		QueuedChunks queued_chunks(max_queued_chunks, {}, {}, RenderContext::getFrameArena());
+		if (!findChunk(chunk_origin) && !isGenerating(chunk_origin))
+			queued_chunks.emplace(chunk_origin);
+		for (ChunkHandle handle : chunks)
 		{
-			if (distance2(vec3(chunk_origin), vec3(chunk->getPosition())) > (max_chunk_distance2 - 1.0f) || !isChunkVisible(chunk->getPosition()))
+			const Chunk& chunk = getChunk(handle);
+			if (distance2(vec3(chunk_origin), vec3(chunk.getPosition())) > (max_chunk_distance2 - 1.0f) || !chunk.visible)
 				continue;
-			std::vector<Chunk::Coord> missing_neighbors = chunk->getMissingAdjacentNeighborLocations();
+			ArenaVector<Chunk::Coord> missing_neighbors = chunk.getMissingAdjacentNeighborLocations(RenderContext::getFrameArena());
 			for (const auto& missing : missing_neighbors)
 			{
-				if (findChunk(chunk->getPosition() + missing))
+				if (findChunk(chunk.getPosition() + missing) || isGenerating(chunk.getPosition() + missing))
 					continue;
-				queued_chunks.emplace(chunk->getPosition() + missing);
+				queued_chunks.emplace(chunk.getPosition() + missing);
 				if (queued_chunks.size() >= max_queued_chunks)
 					break;
 			}
@@ -159,34 +202,22 @@ void World::update()
 				break;
 		}
 
-		static DebugTimer t3("  generate");
-		t3.begin();
-		for (const auto& chunk : queued_chunks)
-		{
-			chunks.emplace_back(makeShared<Chunk>(chunk));
-			chunks.back()->generateStart();
-		}
-		RenderContext::execute();
-		for (size_t i = chunks.size() - queued_chunks.size(); i < chunks.size(); ++i)
 		{
-			const auto& chunk = chunks[i];
-			chunk->generateEnd();
-			for (size_t i = 0; i < 26; ++i)
-				chunk->addNeighbor(i, findChunk(chunk->getPosition() + Chunk::NEIGHBORS[i]));
-		}
-		t3.end();
-		if (t3.getSamples() >= 64)
-		{
-			t3.print(t3.getAverage());
-			t3.reset();
+			SK_PROFILE_SCOPE("World::generate");
+			{
+				// Generated on the compute queue, so it doesn't wait behind the previous frame's graphics
+				RenderContext::ComputeScope compute_scope;
+				for (const auto& chunk : queued_chunks)
+				{
+					generating_chunks.emplace_back(chunk_pool.create(chunk), RenderContext::getFrameNumber());
+					getChunk(generating_chunks.back().handle).generateStart();
+				}
+			}
+			// Waited on with the frame's other submissions, World::generateEnd picks the chunks up once it finished
+			if (!queued_chunks.empty())
+				RenderContext::submitCompute();
 		}
 	}
-	t1.end();
-	if (t1.getSamples() >= 64)
-	{
-		t1.print(t1.getAverage());
-		t1.reset();
-	}
 
 	float w = float(Window::get().getWidth()) * 0.5f;
 	float h = float(Window::get().getHeight()) * 0.5f;
@@ -204,39 +235,39 @@ void World::update()
 	DebugRenderer::line(w, h, w + dz.x * s, h + dz.y * s, 2.0f);
 }
 
-void World::render()
+void World::render(const RenderGraph& render_graph)
 {
-	static DebugTimer t("Rendering");
-	t.begin();
+	SK_PROFILE_FUNCTION();
+	// Descriptor writes happen here, so workers binding the materials only record commands
 	line_material->set("GlobalUniform", *DebugRenderer::getGlobalUniformBuffer());
 	line_material->set("texture_atlas", *texture_atlas);
-	line_material->bind();
-	for (size_t i = 0; i < std::min(chunks.size(), size_t(16)); ++i)
-	{
-		const auto& chunk = chunks[i];
-		if (chunk->getVertexCount() == 0 || !chunk->visible)
-			continue;
-		chunk->render();
-	}
-
+	line_material->update();
 	material->set("GlobalUniform", *DebugRenderer::getGlobalUniformBuffer());
 	material->set("texture_atlas", *texture_atlas);
-	material->bind();
-	for (const auto& chunk : chunks)
-	{
-		if (chunk->getVertexCount() == 0 || !chunk->visible)
-			continue;
-		chunk->render();
-	}
-	t.end();
-	if (t.getSamples() >= 64)
-	{
-		t.print(t.getAverage());
-		t.reset();
-	}
-}
+	material->update();
 
-bool World::isChunkVisible(const Chunk::Coord& position) const
-{
-	return camera->frustum.isBoxVisible(Chunk::toWorldCoord(position), Chunk::toWorldCoord(position) + Chunk::DIM);
+	render_graph.record([this] {
+		line_material->bind();
+		vertex_pool->bind();
+		for (size_t i = 0; i < std::min(chunks.size(), size_t(16)); ++i)
+		{
+			const Chunk& chunk = getChunk(chunks[i]);
+			if (chunk.getVertexCount() == 0 || !chunk.visible)
+				continue;
+			chunk.render();
+		}
+	});
+
+	// Every range binds the material itself, secondary command buffers don't inherit bound state
+	render_graph.record(chunks.size(), [this](size_t begin, size_t end) {
+		material->bind();
+		vertex_pool->bind();
+		for (size_t i = begin; i < end; ++i)
+		{
+			const Chunk& chunk = getChunk(chunks[i]);
+			if (chunk.getVertexCount() == 0 || !chunk.visible)
+				continue;
+			chunk.render();
+		}
+	});
 }
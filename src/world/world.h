@@ -1,42 +1,65 @@
 #pragma once
 
 #include "chunk.h"
-#include "silk_engine/utils/thread_pool.h"
+#include "chunk_mesh_cache.h"
+#include "chunk_vertex_pool.h"
+#include "silk_engine/utils/object_pool.h"
+#include "silk_engine/utils/hash_map.h"
 
 class Material;
 class Image;
 class Entity;
 class Camera;
+class RenderGraph;
 
 class World
 {
+public:
+	static constexpr size_t MESH_CACHE_BYTES = 256 * 1024 * 1024;
+	static constexpr bool PERSIST_MESH_CACHE = false;
+	static constexpr size_t VERTEX_POOL_BYTES = 512 * 1024 * 1024;
+	static constexpr const char* BLOCK_DATA_FILE = "res/blocks.txt"; // Optional, registers extra blocks
+
+	using ChunkHandle = ObjectPool<Chunk>::Handle;
+
 public:
 	World();
 
 	void update();
-	void render();
+	void render(const RenderGraph& render_graph);
 
 	Chunk* findChunk(const Chunk::Coord& position)
 	{
-		for (auto& chunk : chunks)
-			if (*chunk == position)
-				return chunk.get();
+		if (auto it = chunk_lookup.find(position); it != chunk_lookup.end())
+			return &getChunk(it->second);
 		return nullptr;
 	}
 
 private:
-	bool isChunkVisible(const Chunk::Coord& position) const;
+	// Generated on the compute queue, read back once the frame it was submitted in finished
+	struct GeneratingChunk
+	{
+		ChunkHandle handle;
+		uint64_t frame = 0;
+	};
 
 private:
-	std::vector<shared<Chunk>> chunks;
-	struct Hash
+	Chunk& getChunk(ChunkHandle handle) { return *chunk_pool.get(handle); }
+	bool isGenerating(const Chunk::Coord& position)
 	{
-		size_t operator()(const Chunk::Coord& coord) const { return ((int64_t(coord.x) << 32) | int64_t(coord.z)) ^ (int64_t(coord.y) << 16); }
-	};
+		return std::ranges::any_of(generating_chunks, [&](const GeneratingChunk& generating) { return getChunk(generating.handle).getPosition() == position; });
+	}
+
+private:
+	unique<ChunkVertexPool> vertex_pool = nullptr; // Before chunk_pool, chunks free their meshes into it when destroyed
+	ObjectPool<Chunk> chunk_pool;
+	std::vector<ChunkHandle> chunks;
+	HashMap<Chunk::Coord, ChunkHandle> chunk_lookup;
+	std::vector<GeneratingChunk> generating_chunks; // Not in chunks or chunk_lookup until their blocks are read back
 	shared<Material> material = nullptr;
 	shared<Material> line_material = nullptr;
 	shared<Image> texture_atlas = nullptr;
 	shared<Entity> player = nullptr;
 	Camera* camera = nullptr;
-	ThreadPool pool = ThreadPool();
+	ChunkMeshCache mesh_cache = ChunkMeshCache(MESH_CACHE_BYTES, PERSIST_MESH_CACHE);
 };
\ No newline at end of file
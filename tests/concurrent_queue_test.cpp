@@ -0,0 +1,204 @@
+#include "test.h"
+#include "silk_engine/utils/concurrent_queue.h"
+
+namespace
+{
+    constexpr uint64_t STOP = std::numeric_limits<uint64_t>::max();
+
+    // Fills to capacity, then keeps popping one and pushing one so head and tail wrap around many times
+    template<typename Queue>
+    void wrapAround()
+    {
+        Queue queue(6);
+        SK_CHECK(queue.getCapacity() == 8);
+        uint64_t pushed = 0;
+        uint64_t popped = 0;
+        while (queue.tryPush(pushed))
+            ++pushed;
+        SK_CHECK(pushed == queue.getCapacity());
+        SK_CHECK(queue.size() == queue.getCapacity());
+        for (size_t lap = 0; lap < 100; ++lap)
+        {
+            uint64_t item = 0;
+            SK_CHECK(queue.tryPop(item) && item == popped++);
+            SK_CHECK(queue.tryPush(pushed++));
+            SK_CHECK(!queue.tryPush(pushed));
+        }
+
+        // Batches that straddle the end of the ring
+        std::array<uint64_t, 5> batch{};
+        while (popped < pushed)
+        {
+            size_t count = queue.tryPop(std::span<uint64_t>(batch));
+            SK_CHECK(count);
+            for (size_t i = 0; i < count; ++i)
+                SK_CHECK(batch[i] == popped++);
+            for (size_t i = 0; i < batch.size(); ++i)
+                batch[i] = pushed + i;
+            pushed += queue.tryPush(std::span<const uint64_t>(batch.data(), popped < 500 ? batch.size() : 0));
+        }
+        uint64_t item = 0;
+        SK_CHECK(queue.empty() && !queue.tryPop(item));
+    }
+
+    // Items left in the queue are destroyed with it
+    template<typename Queue>
+    void destroysRemaining()
+    {
+        auto item = makeShared<int>(0);
+        {
+            Queue queue(4);
+            SK_CHECK(queue.tryPush(item));
+            SK_CHECK(queue.tryPush(item));
+            SK_CHECK(item.use_count() == 3);
+        }
+        SK_CHECK(item.use_count() == 1);
+    }
+
+    // One producer and one consumer through a small ring, mixing single and batch operations. Order is FIFO
+    void spscStress()
+    {
+        constexpr uint64_t COUNT = 1000000;
+        SPSCQueue<uint64_t> queue(16);
+        std::thread producer([&]
+            {
+                std::array<uint64_t, 7> batch{};
+                uint64_t next = 0;
+                while (next < COUNT)
+                {
+                    if (next % 3)
+                    {
+                        queue.push(next++);
+                        continue;
+                    }
+                    size_t count = std::min<uint64_t>(batch.size(), COUNT - next);
+                    for (size_t i = 0; i < count; ++i)
+                        batch[i] = next + i;
+                    size_t pushed = queue.tryPush(std::span<const uint64_t>(batch.data(), count));
+                    if (!pushed)
+                        std::this_thread::yield();
+                    next += pushed;
+                }
+            });
+
+        std::array<uint64_t, 5> batch{};
+        uint64_t expected = 0;
+        while (expected < COUNT)
+        {
+            if (expected % 2)
+            {
+                SK_CHECK(queue.pop() == expected++);
+                continue;
+            }
+            size_t count = queue.tryPop(std::span<uint64_t>(batch));
+            if (!count)
+                std::this_thread::yield();
+            for (size_t i = 0; i < count; ++i)
+                SK_CHECK(batch[i] == expected++);
+        }
+        producer.join();
+        SK_CHECK(queue.empty());
+    }
+
+    // Producers push disjoint ranges through a small ring, consumers mark every value they pop. Every value has to
+    // be seen exactly once, and each producer's values in the order it pushed them
+    void mpmcStress(size_t producers, size_t consumers)
+    {
+        constexpr uint64_t PER_PRODUCER = 200000;
+        MPMCQueue<uint64_t> queue(64);
+        std::vector<std::atomic<uint8_t>> seen(producers * PER_PRODUCER);
+
+        std::vector<std::thread> threads;
+        for (size_t consumer = 0; consumer < consumers; ++consumer)
+        {
+            threads.emplace_back([&, consumer]
+                {
+                    std::vector<uint64_t> last(producers, STOP);
+                    std::array<uint64_t, 4> batch{};
+                    auto see = [&](uint64_t value)
+                    {
+                        SK_CHECK(value < seen.size());
+                        SK_CHECK(seen[value].fetch_add(1, std::memory_order_relaxed) == 0);
+                        uint64_t& previous = last[value / PER_PRODUCER];
+                        SK_CHECK(previous == STOP || previous < value);
+                        previous = value;
+                    };
+                    while (true)
+                    {
+                        if (consumer % 2)
+                        {
+                            size_t count = queue.tryPop(std::span<uint64_t>(batch));
+                            if (!count)
+                                std::this_thread::yield();
+                            bool stop = false;
+                            for (size_t i = 0; i < count; ++i)
+                            {
+                                if (batch[i] == STOP)
+                                    stop = true;
+                                else see(batch[i]);
+                            }
+                            // A batch may have taken another consumer's stop too, hand it back
+                            for (size_t i = 0, stops = 0; i < count; ++i)
+                                if (batch[i] == STOP && stops++)
+                                    queue.push(STOP);
+                            if (stop)
+                                break;
+                            continue;
+                        }
+                        uint64_t value = queue.pop();
+                        if (value == STOP)
+                            break;
+                        see(value);
+                    }
+                });
+        }
+        for (size_t producer = 0; producer < producers; ++producer)
+        {
+            threads.emplace_back([&, producer]
+                {
+                    uint64_t begin = producer * PER_PRODUCER;
+                    std::array<uint64_t, 3> batch{};
+                    for (uint64_t value = begin; value < begin + PER_PRODUCER;)
+                    {
+                        if (value % 4)
+                        {
+                            queue.push(value++);
+                            continue;
+                        }
+                        size_t count = std::min<uint64_t>(batch.size(), begin + PER_PRODUCER - value);
+                        for (size_t i = 0; i < count; ++i)
+                            batch[i] = value + i;
+                        size_t pushed = queue.tryPush(std::span<const uint64_t>(batch.data(), count));
+                        if (!pushed)
+                            std::this_thread::yield();
+                        value += pushed;
+                    }
+                });
+        }
+
+        for (size_t producer = 0; producer < producers; ++producer)
+            threads[consumers + producer].join();
+        for (size_t consumer = 0; consumer < consumers; ++consumer)
+            queue.push(STOP);
+        for (size_t consumer = 0; consumer < consumers; ++consumer)
+            threads[consumer].join();
+
+        for (const auto& count : seen)
+            SK_CHECK(count.load() == 1);
+        SK_CHECK(queue.empty());
+    }
+}
+
+int main()
+{
+    wrapAround<SPSCQueue<uint64_t>>();
+    wrapAround<MPMCQueue<uint64_t>>();
+    destroysRemaining<SPSCQueue<shared<int>>>();
+    destroysRemaining<MPMCQueue<shared<int>>>();
+    spscStress();
+    mpmcStress(1, 1);
+    mpmcStress(4, 4);
+    mpmcStress(8, 2);
+    mpmcStress(2, 8);
+    return 0;
+}
\ No newline at end of file
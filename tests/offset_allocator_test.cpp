@@ -0,0 +1,141 @@
+#include <random>
+#include "test.h"
+#include "silk_engine/utils/offset_allocator.h"
+
+namespace
+{
+    struct Allocation
+    {
+        OffsetAllocator::Range range;
+        size_t size = 0;
+    };
+
+    // Live ranges have to lie inside the capacity, be aligned and not overlap, and the statistics have to add up
+    void checkAllocations(const OffsetAllocator& allocator, const std::vector<Allocation>& allocations)
+    {
+        std::map<size_t, size_t> ranges;
+        size_t used = 0;
+        for (const auto& allocation : allocations)
+        {
+            SK_CHECK(allocation.range && allocator.getSize(allocation.range) == allocation.size);
+            SK_CHECK(allocation.range.offset + allocation.size <= allocator.getCapacity());
+            SK_CHECK(ranges.emplace(allocation.range.offset, allocation.size).second);
+            used += allocation.size;
+        }
+        size_t end = 0;
+        for (const auto& [offset, size] : ranges)
+        {
+            SK_CHECK(offset >= end);
+            end = offset + size;
+        }
+
+        OffsetAllocator::Statistics statistics = allocator.getStatistics();
+        SK_CHECK(statistics.allocations == allocations.size());
+        SK_CHECK(statistics.free + used == allocator.getCapacity());
+        SK_CHECK(statistics.largest_free <= statistics.free);
+        SK_CHECK(statistics.free ? statistics.free_regions : !statistics.free_regions);
+    }
+
+    // Once everything is freed the free ranges have to have merged back into a single one spanning the capacity
+    void checkCoalesced(OffsetAllocator& allocator)
+    {
+        OffsetAllocator::Statistics statistics = allocator.getStatistics();
+        SK_CHECK(statistics.allocations == 0);
+        SK_CHECK(statistics.free == allocator.getCapacity());
+        SK_CHECK(statistics.largest_free == allocator.getCapacity());
+        SK_CHECK(statistics.free_regions == 1);
+        SK_CHECK(statistics.getFragmentation() == 0.0f);
+
+        OffsetAllocator::Range whole = allocator.allocate(allocator.getCapacity());
+        SK_CHECK(whole && whole.offset == 0);
+        SK_CHECK(!allocator.allocate(1));
+        allocator.free(whole);
+    }
+
+    void fuzz(size_t capacity, size_t max_size, uint64_t seed)
+    {
+        std::mt19937_64 random(seed);
+        OffsetAllocator allocator(capacity);
+        std::vector<Allocation> allocations;
+        for (size_t step = 0; step < 100000; ++step)
+        {
+            // Biased towards allocating until it fails, so the allocator spends time both nearly full and nearly empty
+            bool allocate = allocations.empty() || random() % 100 < (step / 5000 % 2 ? 30 : 70);
+            if (allocate)
+            {
+                size_t size = 1 + random() % (random() % 8 ? max_size / 64 : max_size);
+                size_t alignment = size_t(1) << (random() % 8);
+                OffsetAllocator::Range range = allocator.allocate(size, alignment);
+                if (range)
+                {
+                    SK_CHECK(range.offset % alignment == 0);
+                    allocations.push_back({ range, size });
+                }
+                else
+                {
+                    // Only the head of the bin the size rounds down to is checked, so a range less than one bin step
+                    // (an 8th of the size) larger than needed can be missed
+                    size_t search_size = size + alignment - 1;
+                    SK_CHECK(allocator.getStatistics().largest_free < search_size + search_size / 8);
+                }
+            }
+            else
+            {
+                size_t index = random() % allocations.size();
+                allocator.free(allocations[index].range);
+                std::swap(allocations[index], allocations.back());
+                allocations.pop_back();
+            }
+            if (step % 97 == 0)
+                checkAllocations(allocator, allocations);
+        }
+        checkAllocations(allocator, allocations);
+
+        std::shuffle(allocations.begin(), allocations.end(), random);
+        for (const auto& allocation : allocations)
+            allocator.free(allocation.range);
+        checkCoalesced(allocator);
+    }
+
+    // Exact fits, sizes on bin boundaries and exhausting the capacity
+    void edges()
+    {
+        OffsetAllocator allocator(1024);
+        std::vector<Allocation> allocations;
+        for (size_t i = 0; i < 1024; ++i)
+        {
+            OffsetAllocator::Range range = allocator.allocate(1);
+            SK_CHECK(range);
+            allocations.push_back({ range, 1 });
+        }
+        SK_CHECK(!allocator.allocate(1));
+        checkAllocations(allocator, allocations);
+        // Every other one freed leaves no room for 2
+        for (size_t i = 0; i < allocations.size(); i += 2)
+            allocator.free(allocations[i].range);
+        SK_CHECK(!allocator.allocate(2));
+        SK_CHECK(allocator.getStatistics().free_regions == 512);
+        for (size_t i = 1; i < allocations.size(); i += 2)
+            allocator.free(allocations[i].range);
+        checkCoalesced(allocator);
+
+        allocator.free({});
+        OffsetAllocator::Range range = allocator.allocate(1000, 256);
+        SK_CHECK(!range);
+        range = allocator.allocate(768, 256);
+        SK_CHECK(range && range.offset == 0);
+        allocator.free(range);
+
+        allocator.reset();
+        checkCoalesced(allocator);
+    }
+}
+
+int main()
+{
+    edges();
+    fuzz(1 << 20, 1 << 14, 1);
+    fuzz(1000003, 1 << 16, 2);
+    fuzz(size_t(1) << 40, size_t(1) << 32, 3);
+    return 0;
+}
\ No newline at end of file
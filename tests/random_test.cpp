@@ -0,0 +1,105 @@
+#include "test.h"
+#include "silk_engine/utils/random.h"
+#include "silk_engine/utils/cpu.h"
+
+namespace
+{
+    // Counts that aren't a multiple of any SIMD width, so the scalar tail runs too
+    constexpr size_t COUNT = 1027;
+
+    struct Points
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+    };
+
+    // Spans negative coordinates, lattice points and large values, where floor and the hash wrap are easiest to get wrong
+    Points makePoints()
+    {
+        Points points;
+        Random::Stream stream(7);
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            float scale = i % 3 == 0 ? 1000.0f : i % 3 == 1 ? 10.0f : 1.0f;
+            points.x.emplace_back((stream.nextFloat() * 2.0f - 1.0f) * scale);
+            points.y.emplace_back((stream.nextFloat() * 2.0f - 1.0f) * scale);
+            points.z.emplace_back(i % 17 ? (stream.nextFloat() * 2.0f - 1.0f) * scale : float(int(i) - 512));
+        }
+        return points;
+    }
+
+    // The batched functions have to give bit for bit the scalar results on the current SIMD level
+    void compareNoise(const Points& points)
+    {
+        std::vector<float> out(COUNT);
+        Random::noise(points.x, points.y, out);
+        for (size_t i = 0; i < COUNT; ++i)
+            SK_CHECK(out[i] == Random::noise(points.x[i], points.y[i]));
+
+        Random::noise(points.x, points.y, points.z, out);
+        for (size_t i = 0; i < COUNT; ++i)
+            SK_CHECK(out[i] == Random::noise(points.x[i], points.y[i], points.z[i]));
+
+        Random::fbm(5, points.x, points.y, 2.0f, 0.5f, out);
+        for (size_t i = 0; i < COUNT; ++i)
+            SK_CHECK(out[i] == Random::fbm(5, points.x[i], points.y[i], 2.0f, 0.5f));
+
+        Random::fbm(5, points.x, points.y, points.z, 2.0f, 0.5f, out);
+        for (size_t i = 0; i < COUNT; ++i)
+            SK_CHECK(out[i] == Random::fbm(5, points.x[i], points.y[i], points.z[i], 2.0f, 0.5f));
+
+        // Fewer points than one group
+        std::span<float> few(out.data(), 3);
+        Random::noise(points.x, points.y, few);
+        for (size_t i = 0; i < few.size(); ++i)
+            SK_CHECK(few[i] == Random::noise(points.x[i], points.y[i]));
+    }
+
+    // Same sequence as the scalar path, whether read one at a time or filled in unaligned batches
+    void compareStream(const std::vector<uint32_t>& expected)
+    {
+        Random::Stream single(11);
+        for (uint32_t value : expected)
+            SK_CHECK(single.next() == value);
+
+        Random::Stream batched(11);
+        std::vector<uint32_t> values(expected.size());
+        size_t offset = 0;
+        for (size_t size = 1; offset < values.size(); size = size * 3 % 37 + 1)
+        {
+            size = std::min(size, values.size() - offset);
+            if (size == 1)
+                values[offset] = batched.next();
+            else batched.fill(std::span(values.data() + offset, size));
+            offset += size;
+        }
+        SK_CHECK(values == expected);
+    }
+}
+
+int main()
+{
+    Points points = makePoints();
+
+    CPU::setSimdLevel(CPU::SimdLevel::SCALAR);
+    SK_CHECK(CPU::getSimdLevel() == CPU::SimdLevel::SCALAR);
+    std::vector<uint32_t> expected(COUNT);
+    Random::Stream stream(11);
+    for (uint32_t& value : expected)
+        value = stream.next();
+
+    for (CPU::SimdLevel level : { CPU::SimdLevel::SCALAR, CPU::SimdLevel::SSE41, CPU::SimdLevel::AVX2 })
+    {
+        if (level > CPU::getSupportedSimdLevel())
+        {
+            std::printf("Skipping SIMD level %d, not supported\n", int(level));
+            continue;
+        }
+        CPU::setSimdLevel(level);
+        SK_CHECK(CPU::getSimdLevel() == level);
+        compareNoise(points);
+        compareStream(expected);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "test.h"
+#include "silk_engine/utils/thread_pool.h"
+#include "silk_engine/utils/task.h"
+
+namespace
+{
+    struct WorkerAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) const { ThreadPool::get().submit([handle] { handle.resume(); }); }
+        void await_resume() const noexcept {}
+    };
+
+    // Destroyed frames decrement alive, so leaks and double destroys both show up
+    struct Alive
+    {
+        std::atomic<int>& count;
+
+        Alive(std::atomic<int>& count)
+            : count(count) { ++count; }
+        ~Alive() { --count; }
+    };
+
+    Task<int> hop(std::atomic<int>& alive, int value)
+    {
+        Alive frame(alive);
+        co_await WorkerAwaiter();
+        co_return value;
+    }
+
+    Task<> sum(std::atomic<int>& alive, std::atomic<int>& result, int count)
+    {
+        Alive frame(alive);
+        for (int i = 0; i < count; ++i)
+            result += co_await hop(alive, i);
+    }
+
+    Task<> finishesInline(std::atomic<int>& alive, std::atomic<int>& result)
+    {
+        Alive frame(alive);
+        ++result;
+        co_return;
+    }
+
+    void waitUntil(const std::atomic<int>& value, int expected)
+    {
+        while (value != expected)
+            std::this_thread::yield();
+    }
+
+    // Detaching before, while and after the coroutine runs on workers has to run it exactly once and free it exactly once
+    void detach()
+    {
+        std::atomic<int> alive = 0;
+        std::atomic<int> result = 0;
+        for (int iteration = 0; iteration < 2000; ++iteration)
+        {
+            // Not started yet, detach starts it
+            sum(alive, result, 3).detach();
+
+            // Started and running on a worker
+            Task<> running = sum(alive, result, 3);
+            running.start();
+            running.start();
+            running.detach();
+
+            // Already finished
+            Task<> finished = finishesInline(alive, result);
+            finished.start();
+            SK_CHECK(finished.isDone());
+            finished.detach();
+        }
+        waitUntil(result, 2000 * (3 + 3 + 1));
+        waitUntil(alive, 0);
+        ThreadPool::get().wait();
+        SK_CHECK(alive == 0);
+    }
+
+    Task<int> awaitStarted(std::atomic<int>& alive)
+    {
+        Task<int> task = hop(alive, 7);
+        task.start();
+        co_await WorkerAwaiter();
+        co_return co_await task;
+    }
+
+    // Awaiting a task that was already started elsewhere doesn't resume it a second time
+    void awaitStartedTask()
+    {
+        std::atomic<int> alive = 0;
+        std::atomic<int> result = 0;
+        for (int iteration = 0; iteration < 2000; ++iteration)
+        {
+            Task<int> task = awaitStarted(alive);
+            task.start();
+            while (!task.isDone())
+                std::this_thread::yield();
+            result += task.get();
+        }
+        SK_CHECK(result == 2000 * 7);
+        SK_CHECK(alive == 0);
+    }
+}
+
+int main()
+{
+    detach();
+    awaitStartedTask();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// A failed check prints where it failed and exits with 1, so CTest reports the test as failed
+#define SK_CHECK(condition) do { if (!(condition)) { std::fprintf(stderr, "%s:%d: Check failed: %s\n", __FILE__, __LINE__, #condition); std::exit(1); } } while (0)
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "test.h"
+#include "silk_engine/utils/thread_pool.h"
+
+namespace
+{
+    // parallelFor in a tight loop with a fresh stack counter every call, every index has to be visited exactly once
+    void parallelForStress(ThreadPool& pool)
+    {
+        std::vector<std::atomic<uint32_t>> visits(4096);
+        for (size_t iteration = 0; iteration < 20000; ++iteration)
+        {
+            size_t count = 1 + (iteration * 7919) % visits.size();
+            size_t grain = iteration % 3 == 0 ? 0 : 1 + iteration % 64;
+            pool.parallelFor(count, [&](size_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); }, grain);
+            for (size_t i = 0; i < count; ++i)
+                SK_CHECK(visits[i].exchange(0, std::memory_order_relaxed) == 1);
+        }
+    }
+
+    // Nested parallelFor from worker threads, the waiting workers help instead of blocking
+    void nestedParallelFor(ThreadPool& pool)
+    {
+        for (size_t iteration = 0; iteration < 200; ++iteration)
+        {
+            std::atomic<size_t> sum = 0;
+            pool.parallelFor(64, [&](size_t i) { pool.parallelFor(64, [&](size_t j) { sum += i * 64 + j; }); });
+            SK_CHECK(sum == 4096 * 4095 / 2);
+        }
+    }
+
+    // Stack counters waited on and destroyed right away, while jobs and continuations on another pool still finish
+    void jobCounters(ThreadPool& pool, ThreadPool& other_pool)
+    {
+        for (size_t iteration = 0; iteration < 20000; ++iteration)
+        {
+            ThreadPool::JobCounter counter;
+            std::atomic<uint32_t> order = 0;
+            uint32_t first = 0;
+            uint32_t second = 0;
+            ThreadPool::JobHandle job = pool.schedule([&] { first = ++order; }, {}, &counter);
+            other_pool.then(job, [&] { second = ++order; }, &counter);
+            pool.wait(counter);
+            SK_CHECK(first == 1 && second == 2);
+        }
+    }
+
+    void reduceAndScan(ThreadPool& pool)
+    {
+        for (size_t count : { size_t(0), size_t(1), size_t(1000), size_t(100003) })
+        {
+            uint64_t sum = pool.parallelReduce(count, uint64_t(0), [](size_t i) { return uint64_t(i); }, std::plus<>());
+            SK_CHECK(sum == uint64_t(count) * (count ? count - 1 : 0) / 2);
+
+            std::vector<uint32_t> values(count);
+            for (size_t i = 0; i < count; ++i)
+                values[i] = uint32_t(i % 13);
+            std::vector<uint32_t> offsets(count);
+            uint32_t total = pool.parallelExclusiveScan(values, offsets, 0u);
+            uint32_t running = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                SK_CHECK(offsets[i] == running);
+                running += values[i];
+            }
+            SK_CHECK(total == running);
+        }
+    }
+}
+
+int main()
+{
+    ThreadPool pool;
+    ThreadPool other_pool(2);
+    parallelForStress(pool);
+    nestedParallelFor(pool);
+    jobCounters(pool, other_pool);
+    reduceAndScan(pool);
+    return 0;
+}
\ No newline at end of file